@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Allocations made through the global operator new (and frees through delete)
+struct AllocationStats {
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t bytes; // bytes requested by the allocations
+};
+
+// The replaced operator new always forwards to malloc; counting only happens
+// while tracking is enabled, so the hook costs one relaxed load otherwise
+void SetAllocationTracking(bool enabled);
+bool AllocationTrackingEnabled();
+
+// Totals over every thread
+AllocationStats GetAllocationStats();
+
+// Totals for the calling thread only (the profiler charges these to phases)
+AllocationStats GetThreadAllocationStats();
+
+// Bytes the heap really sets aside for an allocation made through operator
+// new: its usable size plus the chunk header in front of it. Falls back to
+// `requested` plus a header where the usable size can't be queried.
+size_t AllocationFootprint(const void* p, size_t requested);
@@ -0,0 +1,72 @@
+#pragma once
+#include "raylib.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum ChartMode {
+    CHART_BARS,    // column height is the value
+    CHART_HEATMAP  // column colour is the value
+};
+
+// -----------------------------------------------------------------------------
+// Pixel-column chart for arrays too large for boxes. Every column of the chart
+// stands for a run of elements (their mean) or, for short arrays, one element
+// spread over several columns. The chart lives in a texture that stays on the
+// GPU: writes only mark their columns dirty, Update redraws those columns into
+// the CPU copy and Draw re-uploads just them with UpdateTextureRec (the
+// software renderer can't update part of a texture and reloads it whole).
+// -----------------------------------------------------------------------------
+class ArrayChart {
+public:
+    explicit ArrayChart(Rectangle bounds);
+    ~ArrayChart();
+    ArrayChart(const ArrayChart&) = delete;
+    ArrayChart& operator=(const ArrayChart&) = delete;
+
+    void SetMode(ChartMode mode);
+    ChartMode Mode() const { return mode; }
+
+    // Starts over for an array of `count` slots; Add every written slot after
+    void Reset(size_t count);
+    void Add(size_t index, int value);
+    size_t Count() const { return count; }
+
+    // Slot `index` changed from oldValue to newValue
+    void Write(size_t index, int oldValue, int newValue);
+
+    void Update();     // redraws the dirty columns (CPU side)
+    void Draw();       // uploads them and draws the chart
+
+private:
+    static const int fullUploadRuns = 32; // more dirty runs than this upload everything
+
+    Rectangle bounds;
+    int width, height;
+    ChartMode mode = CHART_BARS;
+
+    size_t count = 0;
+    std::vector<int64_t> sums;     // per column: sum of its elements
+    int minValue = 0, maxValue = 0;
+
+    std::vector<Color> pixels;     // width x height, row-major like the texture
+    std::vector<uint8_t> dirty;    // per column
+    std::vector<int> dirtyColumns;
+    bool allDirty = true;
+
+    struct Run {
+        int x, columns;
+    };
+    std::vector<Run> pendingRuns;  // redrawn, waiting for upload
+    bool pendingFull = false;
+    std::vector<Color> staging;    // one run packed for UpdateTextureRec
+    Texture2D texture = {};
+    int uploadedColumns = 0;       // last upload, for the caption
+    int uploadCalls = 0;
+
+    void ColumnsOf(size_t index, size_t& first, size_t& last) const; // [first, last)
+    size_t ElementsIn(size_t column) const;
+    void MarkDirty(size_t column);
+    bool Extend(int value);        // true when the value range grew
+    void DrawColumn(int x);
+};
@@ -0,0 +1,153 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Step-by-step history of a sparse int array, whose slots are empty or hold a
+// value. Each step is a few logged writes (index, slot before, slot after), so
+// stepping back or forward replays the log. For long jumps there are
+// checkpoints: copies of the whole array in chunks of chunkSize slots, made
+// copy-on-write, so a checkpoint shares every chunk that nothing wrote to
+// since the one before and costs only the chunks that changed. Chunks with
+// every slot empty aren't stored at all. When the chunks stored pass
+// memoryFactor times the array, every other checkpoint goes and the interval
+// doubles; when the log passes maxWrites, the oldest steps go.
+// -----------------------------------------------------------------------------
+class ArrayHistory {
+public:
+    static const size_t chunkSize = 1024;
+    static const size_t memoryFactor = 3;
+    static const size_t maxWrites = 1 << 20;
+
+    // What a slot holds; an empty slot's value is 0
+    struct Slot {
+        bool occupied;
+        int value;
+        bool operator==(const Slot&) const = default;
+    };
+
+    ArrayHistory() = default;
+    ArrayHistory(const ArrayHistory&) = delete;
+    ArrayHistory& operator=(const ArrayHistory&) = delete;
+
+    // Starts over with `values` as the only step; slot i is empty unless
+    // occupied[i] is set
+    void Reset(const std::vector<int>& values, const std::vector<bool>& occupied);
+
+    // Appends a write to the open step; steps after the cursor are dropped
+    // first. Slots past the end grow the array (new slots are empty).
+    void Record(size_t index, Slot before, Slot after);
+    void EndStep();
+    void DropNewer(); // forgets the steps after the cursor
+
+    size_t FirstStep() const { return firstStep; }   // oldest step kept
+    size_t NewestStep() const { return firstStep + stepEnds.size(); }
+    size_t Cursor() const { return cursor; }
+    bool AtNewest() const { return cursor == NewestStep(); }
+
+    // Moves the cursor to `step` (clamped to the kept steps), calling
+    // apply(index, slot) for each slot it changes, emptied ones included
+    template <class Apply>
+    void Seek(size_t step, Apply&& apply);
+
+    size_t StoredChunks() const { return storedChunks; }
+    size_t ArrayChunks() const { return live.size(); }
+    size_t CheckpointCount() const { return checkpoints.size(); }
+    size_t FootprintBytes() const;
+
+private:
+    struct Chunk {
+        int values[chunkSize];
+        uint64_t occupied[chunkSize / 64];
+    };
+    struct ChunkDeleter {
+        size_t* stored;
+        void operator()(Chunk* chunk) const;
+    };
+    typedef std::shared_ptr<Chunk> ChunkPtr;
+
+    struct Write {
+        uint32_t index;
+        int32_t before;
+        int32_t after;
+        bool occupiedBefore;
+        bool occupiedAfter;
+    };
+    struct Checkpoint {
+        size_t step;
+        std::vector<ChunkPtr> chunks;
+    };
+
+    size_t storedChunks = 0; // declared first: outlives every chunk
+    std::vector<ChunkPtr> live; // the array at the cursor; null chunks are empty
+    size_t size = 0;
+
+    std::vector<Write> writes;
+    std::vector<size_t> stepEnds; // step firstStep + k + 1 ends at writes[stepEnds[k]]
+    size_t firstStep = 0;
+    size_t cursor = 0;
+
+    std::vector<Checkpoint> checkpoints; // [0] is at firstStep
+    size_t interval = 4096;              // steps between checkpoints
+
+    ChunkPtr NewChunk(const Chunk* copyOf);
+    static Slot SlotIn(const Chunk* chunk, size_t k);
+    void SetLive(size_t index, Slot slot);
+    size_t WriteOffset(size_t step) const { return step == firstStep ? 0 : stepEnds[step - firstStep - 1]; }
+    size_t WritesBetween(size_t a, size_t b) const;
+    const Checkpoint& CheckpointBefore(size_t step) const;
+    size_t ChunksDiffering(const Checkpoint& checkpoint) const;
+    void TakeCheckpoint();
+    void Thin();
+    void TrimLog();
+};
+
+template <class Apply>
+void ArrayHistory::Seek(size_t step, Apply&& apply) {
+    EndStep();
+    step = step < firstStep ? firstStep : step > NewestStep() ? NewestStep() : step;
+    if (step == cursor) return;
+
+    // Restoring a checkpoint compares the chunks that differ from it; take
+    // that route when it beats replaying the log from here (short moves
+    // don't even look)
+    size_t direct = WritesBetween(cursor, step);
+    const Checkpoint& checkpoint = CheckpointBefore(step);
+    if (direct > chunkSize
+        && ChunksDiffering(checkpoint) * chunkSize + WritesBetween(checkpoint.step, step) < direct) {
+        for (size_t c = 0; c < live.size(); c++) {
+            // Missing chunks are empty (slots added since the checkpoint too)
+            const Chunk* saved = c < checkpoint.chunks.size() ? checkpoint.chunks[c].get() : nullptr;
+            const Chunk* shown = live[c].get();
+            if (saved == shown) continue;
+            // Empty slots hold 0, so a slot differs if its value or its bit does
+            for (size_t k = 0; k < chunkSize; k++) {
+                int value = saved ? saved->values[k] : 0;
+                uint64_t bits = (saved ? saved->occupied[k / 64] : 0) ^ (shown ? shown->occupied[k / 64] : 0);
+                if ((shown ? shown->values[k] : 0) != value || (bits >> (k % 64) & 1))
+                    apply(c * chunkSize + k, SlotIn(saved, k));
+            }
+            live[c] = saved ? checkpoint.chunks[c] : nullptr;
+        }
+        cursor = checkpoint.step;
+    }
+
+    while (cursor > step) {
+        for (size_t w = WriteOffset(cursor); w-- > WriteOffset(cursor - 1);) {
+            Slot slot = { writes[w].occupiedBefore, writes[w].before };
+            SetLive(writes[w].index, slot);
+            apply(writes[w].index, slot);
+        }
+        cursor--;
+    }
+    while (cursor < step) {
+        cursor++;
+        for (size_t w = WriteOffset(cursor - 1); w < WriteOffset(cursor); w++) {
+            Slot slot = { writes[w].occupiedAfter, writes[w].after };
+            SetLive(writes[w].index, slot);
+            apply(writes[w].index, slot);
+        }
+    }
+}
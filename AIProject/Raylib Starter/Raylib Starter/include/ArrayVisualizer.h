@@ -1,24 +1,48 @@
 #pragma once
 #include "raylib.h"
+#include "ArrayChart.h"
+#include "ArrayHistory.h"
+#include "CacheView.h"
+#include "GrowthPolicy.h"
+#include "ModelWorker.h"
+#include "SortedArraySearch.h"
+#include "SparseArray.h"
+#include "Sorting.h"
+#include "TweenEngine.h"
 #include <vector>
 #include <string>
 
+// y, highlight and compare are driven by the visualizer's tween engine; x
+// follows from the slot index and the scroll position
 struct AnimatedElement {
     int value;
-    float x, y;
-    float targetY;
-    float highlightTimer; // for visual feedback (seconds)
+    float y;
+    float highlight; // 1 when just written, fading to 0
+    float compare;   // 1 while a sort compares this element, fading to 0
 
-    AnimatedElement(int v, float xpos, float ypos, float tY)
-        : value(v), x(xpos), y(ypos), targetY(tY), highlightTimer(0.0f) {
+    AnimatedElement(int v = 0, float ypos = 0.0f)
+        : value(v), y(ypos), highlight(0.0f), compare(0.0f) {
     }
 };
 
+// Boxes show every slot with its value; past a few hundred slots the chart
+// views show the whole array, one pixel column per run of elements
+enum ArrayView {
+    VIEW_BOXES,
+    VIEW_BARS,
+    VIEW_HEATMAP,
+    VIEW_COUNT
+};
+
 
 class ArrayVisualizer {
 private:
     int screenWidth, screenHeight;
-    std::vector<AnimatedElement> elements;
+    // Only written slots are stored, so huge sizes cost nothing until used;
+    // slots never move, so tweens can point into them
+    SparseArray<AnimatedElement> elements;
+    TweenEngine tweens;
+    size_t firstSlot = 0; // leftmost slot on screen
 
     std::string inputValue;   // for entering element values
     std::string sizeInput;    // for entering array size
@@ -39,6 +63,108 @@ private:
     Rectangle indexBox;
     Rectangle setAtIndexButton;
 
+    // Sorted array search mode: the same keys in three layouts
+    bool searchMode = false;
+    SortedArraySearch searchEngine;
+    std::vector<SearchProbe> searchProbes[LAYOUT_COUNT];
+    int searchResult[LAYOUT_COUNT] = {};
+    int searchValue = 0;
+    int searchStep = 0;
+    float searchTimer = 0.0f;
+    float searchDelay = 0.6f; // seconds per probe
+    bool searchAnimating = false;
+    double nsPerLookup[LAYOUT_COUNT][KERNEL_COUNT] = {};
+    bool lookupsMeasured = false;
+    std::vector<Color> searchCellColors; // reused by DrawSearchLayouts
+
+    Rectangle searchModeButton;
+    Rectangle findButton;
+    Rectangle measureButton;
+
+    // Sorting: the model worker sorts a copy and streams its trace, which is
+    // replayed over the elements
+    SortAlgorithm sortAlgorithm = SORT_INTROSORT;
+    ModelWorker worker;
+    std::vector<size_t> sortSlots; // the written slots being sorted, in order
+    // Insertion sort makes about n^2 / 2 steps: past this many elements the
+    // replay would never end, so the Sort button refuses it
+    static const size_t quadraticSortLimit = 5000;
+    uint64_t sortCursor = 0;
+    uint64_t sortEventCount = 0; // estimated while the sort runs, then the count
+    uint64_t sortCompares = 0, sortSwaps = 0, sortWrites = 0;
+    float sortBudget = 0.0f; // events owed to the replay (fractional)
+    bool sortReplaying = false;
+
+    Rectangle algorithmButton;
+    Rectangle sortButton;
+
+    CacheView cacheView{ { 660, 240 } };
+
+    // Chart views: writes go to the chart as they happen; anything that
+    // replaces the elements wholesale marks it stale for a rebuild
+    ArrayView view = VIEW_BOXES;
+    ArrayChart chart;
+    bool chartStale = true;
+    Rectangle viewButton;
+    Rectangle fillButton;
+
+    // Every write (edits, pushes, sort steps) is logged as a step; stepping
+    // back pauses a sort replay, which carries on once the newest step is
+    // shown again. Edits made further back drop the newer steps.
+    ArrayHistory history;
+    bool historyStale = true;
+    bool historyOff = false; // a write past historySlots; back on after a clear
+    static const size_t historySlots = 1 << 24;
+    Rectangle stepBackButton;
+    Rectangle stepForwardButton;
+    Rectangle timeline;
+    bool scrubbing = false;
+
+    // Vector mode: any policy but GROWTH_FIXED makes Add grow the buffer
+    // (maxSize is its capacity) and Set Size reserve. Growing animates the
+    // copy into the new block one element at a time, then the old block is
+    // freed and the new one takes its place.
+    GrowthPolicy growthPolicy = GROWTH_FIXED;
+    Rectangle growthButton;
+    size_t pushes = 0;
+    size_t reallocations = 0;
+    size_t elementsCopied = 0;
+    size_t peakBytes = 0;
+    bool reallocating = false;
+    int newCapacity = 0;
+    float reallocCopied = 0.0f; // elements moved into the new block so far
+    float reallocSlide = 0.0f;  // 0..1 once every element has moved
+    bool pushPending = false;   // the push that triggered the growth
+    int pendingValue = 0;
+
+    AnimatedElement& PlaceElement(size_t index, int value, float y);
+    int ValueAt(size_t index) const; // 0 for empty slots
+    void ClearElements();
+    size_t VisibleSlots() const;
+    void ScrollTo(size_t index);
+    void Flash(AnimatedElement& e, float seconds);
+    void NoteWrite(size_t index, const AnimatedElement* old, int newValue); // old is null for an empty slot
+    void RebuildChart();
+    void FillRandom();
+    void ResetHistory();
+    void SeekHistory(size_t step);
+    void DrawTimeline();
+
+    void PushElement(int value);
+    void StartReallocation(int capacity);
+    void UpdateReallocation(float dt);
+    void ResetGrowthStats();
+
+    bool SortAllowed() const;
+    void StartSort();
+    void ReplaySortEvents(float dt);
+    void ApplySortEvent(const VisEvent& e);
+
+    void BuildSearchLayouts();
+    void StartLayoutSearch(int value);
+    void MeasureLayouts();
+    void DrawSearchLayouts();
+
 public:
     ArrayVisualizer(int w, int h);
 
@@ -46,4 +172,30 @@ public:
     void UpdateAnimations();
     void DrawUI();
     void Draw();
+
+    // Benchmarks: replace the contents without animating
+    void SetValues(const std::vector<int>& values);
+
+    // Scripted scenarios: what the algorithm and sort buttons do, but waits
+    // for the trace so every run replays it the same way
+    void SortWith(SortAlgorithm algorithm);
+
+    // The written slots and the settings that shape them, for rebuilding
+    // the array in a new visualizer (the mode registry's compact and evict).
+    // History, growth stats and a sort still replaying are left behind; the
+    // values are kept as they stand.
+    struct Snapshot {
+        int maxSize;
+        std::vector<size_t> slots;
+        std::vector<int> values;
+        ArrayView view;
+        SortAlgorithm sortAlgorithm;
+        GrowthPolicy growthPolicy;
+    };
+    Snapshot TakeSnapshot() const;
+    void Restore(const Snapshot& snapshot);
+
+    // Addresses one operation touches, element = index. Search scans for
+    // `key`; insert shifts everything from index `key` up by one.
+    void TraceOperation(CacheTraceOp op, int key, AddressTrace& trace) const;
 };
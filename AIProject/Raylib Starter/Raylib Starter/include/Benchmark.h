@@ -0,0 +1,54 @@
+#pragma once
+#include "AllocationTracker.h"
+#include "PerfCounters.h"
+#include <cstddef>
+#include <chrono>
+
+// -----------------------------------------------------------------------------
+// Benchmark mode: "Raylib Starter.exe --bench [--counters] [name...]"
+// Runs the data-structure benchmarks without opening a window. --counters adds
+// per-op hardware counters to every timed region where the OS allows them.
+// -----------------------------------------------------------------------------
+int RunBenchmarks(int argc, char** argv);
+
+// -----------------------------------------------------------------------------
+// Times one region of a benchmark and prints ns/op when stopped, followed by
+// the hardware counters per op when they are enabled. Counters only see the
+// calling thread, so job system regions undercount.
+// -----------------------------------------------------------------------------
+class BenchTimer {
+public:
+    BenchTimer(const char* label, size_t ops);
+    ~BenchTimer();
+
+    double Stop(); // seconds elapsed, prints the result once
+    void SetOps(size_t count) { ops = count; } // for runs whose length isn't known up front
+
+private:
+    const char* label;
+    size_t ops;
+    bool stopped;
+    double seconds;
+    std::chrono::steady_clock::time_point start;
+    PerfCounters counters;
+    bool counting;
+};
+
+// -----------------------------------------------------------------------------
+// Fails the benchmark run when a region makes more than `budget` allocations
+// (on any thread). Checked when stopped or at the end of the scope.
+// -----------------------------------------------------------------------------
+class AllocationBudget {
+public:
+    AllocationBudget(const char* label, uint64_t budget);
+    ~AllocationBudget();
+
+    bool Check(); // true when within budget, prints the result once
+
+private:
+    const char* label;
+    uint64_t budget;
+    bool checked;
+    bool passed;
+    AllocationStats start;
+};
@@ -1,7 +1,14 @@
 ﻿#pragma once
 #include "raylib.h"
+#include "CacheView.h"
+#include "Generator.h"
+#include "ModelWorker.h"
+#include "JobSystem.h"
+#include "MemoryLayoutView.h"
+#include "NodePool.h"
+#include "TreeHistory.h"
+#include "TweenEngine.h"
 #include <vector>
-#include <queue>
 #include <string>
 #include <functional>
 
@@ -9,31 +16,100 @@ struct TreeNode {
     int value;
     TreeNode* left;
     TreeNode* right;
-    Vector2 position;
+    Vector2 position;       // tweened toward targetPosition
     Vector2 targetPosition;
-    bool animating;
     bool positioned;
 
     bool searchHighlight = false;
     bool insertHighlight = false;
     bool foundNode = false; // NEW: indicates node was found
 
-    bool fading = false;           // true when green→blue fade
-    Color currentColor = BLUE;    // smooth transition
-    Color targetColor = BLUE;     // the color we are interpolating toward
-    float fadeTimer = 0.0f;
+    // Drawn as LerpColor(fromColor, targetColor, colorMix); colorMix is tweened
+    Color fromColor = BLUE;
+    Color targetColor = BLUE;
+    float colorMix = 1.0f;
+
+    int subtreeSize = 1; // filled in by Relayout
+    uint32_t id = 0;     // the TreeHistory node this one shows
+};
+
+
+// Result of one key in a batched search
+struct BatchSearchResult {
+    bool found;
+    int pathLength; // nodes visited, including the matching node
 };
 
 
+// One step of an animated tree algorithm. The algorithms are coroutines that
+// co_yield these; the animator pulls the next one when the current step's
+// time on screen is up.
+enum TreeStepType {
+    STEP_VISIT,       // search reached node
+    STEP_FOUND,       // search matched node
+    STEP_NOT_FOUND,   // search fell off the tree
+    STEP_DESCEND,     // insertion moves from node to next
+    STEP_ATTACH,      // insertion linked node below next (nullptr for a new root)
+    STEP_BATCH_ROUND, // every batch search path has reached depth `round`
+    STEP_BATCH_DONE
+};
+
+// How Relayout places nodes
+enum TreeLayout {
+    TREE_LAYOUT_MIDPOINT, // each node halves its parent's horizontal range
+    TREE_LAYOUT_COMPACT   // in-order: every node gets its own column
+};
+
+struct TreeStep {
+    TreeStepType type;
+    TreeNode* node = nullptr;
+    TreeNode* next = nullptr;
+    int round = 0;
+};
+
 
 class BinaryTree {
 public:
     BinaryTree(int screenWidth, int screenHeight);
+    ~BinaryTree();
+    BinaryTree(const BinaryTree&) = delete;
+    BinaryTree& operator=(const BinaryTree&) = delete;
 
     void Insert(int value);
+    void InsertImmediate(int value); // no animation, for bulk loads
+    void Delete(int value);
+
+    // Version timeline: every insert, delete and load is a version
+    void ShowVersion(size_t version);
+    const TreeHistory& History() const { return history; }
     void UpdateAnimations();
     void Draw();
 
+    // Addresses one operation touches, element = visit order. Search looks
+    // for `key`; insert walks the path `key` would be attached at.
+    void TraceOperation(CacheTraceOp op, int key, AddressTrace& trace);
+
+    // Node storage: operator new (default) or a NodePool. Switching copies
+    // the tree across in pre-order and waits until no animation holds nodes.
+    void SetPooled(bool pooled);
+    bool Pooled() const { return usePool; }
+    void CollectNodes(std::vector<const void*>& out) const; // in order
+    void CollectKeys(std::vector<int>& out) const; // current version, pre-order
+    size_t FootprintBytes() const; // node storage including allocator overhead
+
+    // Non-animated lookups
+    bool Contains(int value, int* pathLength = nullptr) const;
+    void SearchBatch(const int* keys, size_t count, BatchSearchResult* results) const;
+
+    // Number of keys descended in lockstep by SearchBatch
+    static const int batchLanes = 16;
+
+    // Recomputes every node's position (and subtree sizes), forking large
+    // subtrees onto the job system
+    void Relayout(JobSystem& jobs);
+    void SetLayout(TreeLayout newLayout);
+    TreeLayout Layout() const { return layout; }
+
     // Binary tree specific UI
     void DrawUI();               // Draw input boxes + search button
     void HandleInput();          // Handle input for search & insert
@@ -41,14 +117,19 @@ public:
 private:
     TreeNode* root;
     int screenWidth, screenHeight;
-    std::vector<TreeNode*> animatingNodes;
-
-    // Search animation
-    std::queue<TreeNode*> searchQueue;
-    bool searching = false;
-    int searchTarget = 0;
+    TweenEngine tweens; // node positions and colours
+    float moveDuration = 0.8f;
+
+    // Algorithm being animated and the step currently on screen
+    Generator<TreeStep> steps;
+    TreeStep step = {};
+    bool playing = false;
+    float stepTimer = 0.0f;
     float searchDelay = 0.5f; // seconds between highlighting nodes
-    float searchTimer = 0.0f;
+    float arrowSpeed = 1.5f;  // edges per second during insertion
+    float arrowProgress = 0.0f;
+    TreeNode* lastSearchHighlight = nullptr;
+    std::vector<TreeNode*> insertPath; // lit by the running insert's descent
 
     // UI state
     std::string inputValue;
@@ -59,28 +140,95 @@ private:
     Rectangle searchBox;
     Rectangle insertBtn;
     Rectangle searchBtn;
-
-    // Animated insertion traversal
-    bool inserting = false;
-    int insertValue = 0;
-    std::vector<TreeNode*> insertPath;
-    int insertStep = 0;
-    float insertTimer = 0.0f;
-    float insertDelay = 0.8f;
-
-    TreeNode* currentInsertNode = nullptr;
-    TreeNode* nextInsertNode = nullptr;
-    float arrowProgress = 0.0f;
+    Rectangle batchBtn;
+    Rectangle skipBtn;
+    Rectangle bulkBtn;
+    Rectangle layoutBtn;
+    Rectangle deleteBtn;
+    Rectangle undoBtn;
+    Rectangle redoBtn;
+    Rectangle timeline;
+    bool scrubbing = false;
+
+    // The nodes on screen always show history's current version;
+    // visualNodes[id] is the node standing for version node `id`
+    TreeHistory history;
+    std::vector<TreeNode*> visualNodes;
+
+    // Cache view; cacheNodes[e] is the node trace element e refers to
+    CacheView cacheView{ { 1020, 100 } };
+    std::vector<TreeNode*> cacheNodes;
+    size_t nodeCount = 0;
+
+    NodePool<TreeNode> pool;
+    bool usePool = false;
+    MemoryLayoutView memoryView{ { 610, 170 }, { 50, screenHeight - 140.0f, screenWidth - 100.0f, 30 } };
+
+    // Full layout. Subtree sizes aren't known on the way down, so measuring
+    // forks the top levels; placing forks every subtree above layoutForkSize.
+    TreeLayout layout = TREE_LAYOUT_MIDPOINT;
+    float layoutLeft = 0.0f;   // x of the first compact column
+    float layoutColumn = 0.0f; // width of a compact column
+    static const int layoutForkDepth = 6;
+    static const int layoutForkSize = 4096;
+
+    // Bulk insert stops the tree at this many nodes, which still lays out and
+    // draws at interactive rates
+    static const int maxBulkNodes = 1000000;
 
     std::string notificationText;
     float notificationTimer = 0.0f;   // display duration
     float notificationDuration = 2.0f; // 2 seconds
 
-    TreeNode* nodeToHighlight = nullptr; // node to highlight after search
+    // Batch search animation: one coloured path per key, all advancing together
+    std::vector<TreeNode*> batchPaths;   // every path, back to back
+    std::vector<size_t> batchOffsets;    // path k is [batchOffsets[k], batchOffsets[k + 1])
+    std::vector<BatchSearchResult> batchResults;
+    int batchStep = 0;
+
+    // Bulk insertion runs on the model worker; its events build our nodes
+    ModelWorker worker;
+    std::vector<TreeNode*> nodeById;  // the worker's node ids -> our nodes
+    TreeNode* unlinkedNode = nullptr; // created, link event not applied yet
+    int bulkTotal = 0;                // 0 when no bulk insert is running
+    int bulkApplied = 0;
+    bool bulkCapped = false;          // asked for more than maxBulkNodes allows
+    size_t drainBudget = 20000;       // events applied per frame
+
+    TreeNode* NewNode(const TreeNode& init);
+    void FreeNode(TreeNode* node);
+    void TrackNode(TreeNode* node, uint32_t id);
+    TreeNode* VisualFor(const VersionNode* v);
+    void SyncVisuals(const VersionNode* from);
+    void DrawTimeline();
 
     void DrawNode(TreeNode* node);
-    void UpdateNode(TreeNode* node, float dt);
+    void AnimatePosition(TreeNode* node);
+    void SetNodeColor(TreeNode* node, Color color, float duration);
+    void ResetHighlight(TreeNode* node); // fades it back to blue
     void ComputeNodePositions(TreeNode* node, int depth, int xMin, int xMax);
+    int MeasureSubtree(TreeNode* node, int depth, JobSystem& jobs);
+    void PlaceSubtree(TreeNode* node, int depth, float xMin, float xMax, int firstColumn, JobSystem& jobs);
+    void AnimateToTargets(TreeNode* node);
 
     void Search(int value);
+    void StartBatchSearch(const std::string& keyList);
+    void DrawBatchPaths();
+
+    // Step coroutines: straight-line algorithms that yield what to show
+    Generator<TreeStep> InsertSteps(int value);
+    Generator<TreeStep> SearchSteps(int value);
+    Generator<TreeStep> BatchSearchSteps(std::vector<int> keys);
+
+    // Animator
+    void Play(Generator<TreeStep> algorithm);
+    bool AdvanceStep();
+    void ApplyStep(const TreeStep& s);
+    void UpdateSteps(float dt);
+    void FinishSteps(); // runs the rest of the current algorithm without pausing
+    float StepDuration(const TreeStep& s) const;
+
+    void StartBulkInsert(int count);
+    void ApplyModelEvent(const VisEvent& e);
+    void PlaceChild(TreeNode* parent, TreeNode* child, bool right);
 };
@@ -6,8 +6,19 @@ class BinaryTreeVisualizer {
 public:
     BinaryTreeVisualizer(int width, int height);
     void Update();
+    void Tick(); // animations only, no input (multi-pane view)
     void Draw();
 
+    // The tree's keys in pre-order (inserting them in that order rebuilds
+    // the same shape) and its layout. The version history isn't kept: a
+    // restored tree starts with one load version.
+    struct Snapshot {
+        std::vector<int> keys;
+        TreeLayout layout;
+    };
+    Snapshot TakeSnapshot() const;
+    void Restore(const Snapshot& snapshot);
+
 private:
     int screenWidth, screenHeight;
     BinaryTree tree;
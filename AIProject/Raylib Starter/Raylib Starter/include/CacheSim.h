@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One memory access made by a structure operation. `element` is the
+// structure's own index for whatever was touched (array index, list position,
+// tree visit order) so the result can be drawn on it.
+struct TraceAccess {
+    uintptr_t address;
+    uint32_t bytes;
+    int element;
+};
+
+using AddressTrace = std::vector<TraceAccess>;
+
+inline void RecordAccess(AddressTrace& trace, const void* p, size_t bytes, int element) {
+    trace.push_back({ (uintptr_t)p, (uint32_t)bytes, element });
+}
+
+// Operations the structures can trace
+enum CacheTraceOp {
+    CACHE_TRACE_TRAVERSE,
+    CACHE_TRACE_SEARCH,
+    CACHE_TRACE_INSERT,
+    CACHE_TRACE_OP_COUNT
+};
+
+const char* CacheTraceOpName(CacheTraceOp op);
+
+struct CacheLevelConfig {
+    const char* name;
+    uint32_t sizeBytes;
+    uint32_t ways;
+};
+
+struct CacheLevelStats {
+    uint64_t hits;
+    uint64_t misses;
+};
+
+// Named hierarchies for the view to cycle through
+struct CachePreset {
+    const char* name;
+    uint32_t lineBytes;
+    CacheLevelConfig levels[3];
+};
+
+extern const CachePreset cachePresets[];
+extern const int cachePresetCount;
+
+// -----------------------------------------------------------------------------
+// Set-associative cache hierarchy with LRU replacement in every level. A line
+// that misses everywhere comes from memory and is filled into every level it
+// missed in. Only tracks which lines are present; no data, no prefetching.
+// -----------------------------------------------------------------------------
+class CacheSimulator {
+public:
+    explicit CacheSimulator(const CachePreset& preset);
+
+    void Reset(); // empty every level and zero the stats
+    void ResetStats();
+
+    // Touches [address, address + bytes); returns the level that served it
+    // (the slowest over the lines it spans), LevelCount() meaning memory
+    int Access(uintptr_t address, uint32_t bytes);
+
+    // Replays a trace from cold caches, or from caches warmed by one untimed
+    // run of the same trace. elementLevels[e] gets the slowest level any
+    // access to element e was served from (-1 for untouched elements).
+    void Replay(const AddressTrace& trace, bool warm, std::vector<int8_t>& elementLevels);
+
+    int LevelCount() const { return (int)levels.size(); }
+    const CacheLevelConfig& Level(int level) const { return levels[level].config; }
+    const CacheLevelStats& Stats(int level) const { return levels[level].stats; }
+    uint64_t LineAccesses() const { return lineAccesses; }
+    uint64_t MemoryAccesses() const { return memoryAccesses; }
+    uint32_t LineBytes() const { return lineBytes; }
+
+private:
+    struct LevelState {
+        CacheLevelConfig config;
+        uint32_t sets;
+        std::vector<uint64_t> lines;   // sets * ways, line number + 1 (0 = empty)
+        std::vector<uint64_t> lastUse; // LRU stamps, parallel to lines
+        CacheLevelStats stats;
+    };
+
+    std::vector<LevelState> levels;
+    uint32_t lineBytes;
+    uint64_t clock = 0;
+    uint64_t lineAccesses = 0;
+    uint64_t memoryAccesses = 0;
+
+    int AccessLine(uint64_t line);
+    bool Lookup(LevelState& level, uint64_t line);
+    void Fill(LevelState& level, uint64_t line);
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include "raylib.h"
+#include "CacheSim.h"
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Cache view shared by the visualizers. The structure records the addresses
+// one operation touches, the view replays them through a CacheSimulator, and
+// the structure draws a marker on each element coloured by the level that
+// served it. The controls cycle the operation (or off), the hierarchy preset
+// and cold/warm replays.
+// -----------------------------------------------------------------------------
+class CacheView {
+public:
+    explicit CacheView(Vector2 origin);
+
+    // Handles the buttons; call once per frame
+    void HandleInput();
+
+    bool Active() const { return active; }
+    CacheTraceOp Op() const { return op; }
+
+    // True when the trace for (key, elementCount) has to be rebuilt: the
+    // controls changed, or the structure/key did since the last replay
+    bool NeedsReplay(int key, size_t elementCount);
+    void Invalidate() { dirty = true; } // the structure's nodes moved
+
+    // Cleared trace for the structure to fill, then replay it
+    AddressTrace& BeginTrace();
+    void Replay();
+
+    // -1 when the last replay didn't touch the element
+    int ElementLevel(size_t element) const;
+
+    // Ring (or frame) around an element, coloured by the level that served it
+    void DrawMarker(Vector2 center, float radius, size_t element) const;
+    void DrawMarker(Rectangle bounds, size_t element) const;
+
+    void Draw() const; // buttons, miss ratios and legend
+
+    static Color LevelColor(int level, int levelCount);
+
+private:
+    Rectangle opButton;
+    Rectangle presetButton;
+    Rectangle warmButton;
+
+    bool active = false;
+    CacheTraceOp op = CACHE_TRACE_TRAVERSE;
+    int preset = 0;
+    bool warm = false;
+    bool dirty = true;
+    int lastKey = 0;
+    size_t lastCount = 0;
+
+    CacheSimulator cache;
+    AddressTrace trace;
+    std::vector<int8_t> elementLevels;
+};
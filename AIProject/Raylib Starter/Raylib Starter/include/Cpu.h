@@ -0,0 +1,69 @@
+#pragma once
+
+// -----------------------------------------------------------------------------
+// Small CPU helpers shared by the search/sort kernels
+// -----------------------------------------------------------------------------
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+// GCC/Clang only emit AVX2/SSE4.1 instructions inside functions that ask for
+// them; MSVC allows the intrinsics anywhere. Kernels using these must only be
+// called after checking GetCpuFeatures().
+#if defined(_MSC_VER)
+#define TARGET_SSE41
+#define TARGET_AVX2
+#else
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2,popcnt,bmi")))
+#endif
+
+// Instruction sets detected at runtime with cpuid. The kernel levels include
+// what their kernels also use: PopCount is the POPCNT instruction on MSVC, and
+// TARGET_AVX2 lets GCC/Clang emit POPCNT and BMI1, so sse41 is only set with
+// POPCNT and avx2 only with both.
+struct CpuFeatures {
+    bool sse41;
+    bool avx2;
+    bool popcnt;
+    bool bmi1;
+};
+
+const CpuFeatures& GetCpuFeatures();
+
+// Hint the cache to start loading the line holding `p` (null is harmless)
+inline void Prefetch(const void* p) {
+    _mm_prefetch((const char*)p, _MM_HINT_T0);
+}
+
+// Index of the lowest set bit; x must not be zero
+inline int CountTrailingZeros(unsigned int x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return (int)index;
+#else
+    return __builtin_ctz(x);
+#endif
+}
+
+// Index of the highest set bit; x must not be zero
+inline int HighestSetBit(unsigned int x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, x);
+    return (int)index;
+#else
+    return 31 - __builtin_clz(x);
+#endif
+}
+
+inline int PopCount(unsigned int x) {
+#if defined(_MSC_VER)
+    return (int)__popcnt(x);
+#else
+    return __builtin_popcount(x);
+#endif
+}
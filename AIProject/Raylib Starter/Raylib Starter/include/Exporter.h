@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Export mode: "Raylib Starter.exe --export <scenario> <out.gif | folder>
+//     [--frames N] [--fps F] [--scale S]"
+// Plays a scripted scenario (Scenario.h) on a fixed time step into an
+// OffscreenTarget, as fast as readback and the encoders allow. A
+// path ending in .gif makes one GIF; anything else is a folder of numbered
+// PNGs. Frame rates default to 50 for GIFs and 60 for PNGs; scenarios keep
+// their length in seconds. With no arguments it lists the scenarios.
+// -----------------------------------------------------------------------------
+int RunExport(int argc, char** argv);
+
+enum ExportFormat {
+    EXPORT_GIF,
+    EXPORT_PNG
+};
+
+// -----------------------------------------------------------------------------
+// Encodes frames on a pool of encoder threads while the caller renders the
+// next ones. Frames are grouped into segments of consecutive frames, one per
+// job. A GIF segment is a small GIF of its own (msf_gif quantizes each frame
+// against the one before it, so a segment can't be split further); the file is
+// the first segment's header followed by every segment's frames, written in
+// order as segments finish. PNG segments write one file per frame. Submit
+// waits when every segment buffer is in use, so memory stays bounded however
+// far the renderer gets ahead.
+// -----------------------------------------------------------------------------
+class FrameEncoder {
+public:
+    // `threads` 0 means one per hardware thread
+    FrameEncoder(ExportFormat format, const std::string& path, int width, int height, float fps,
+        unsigned threads = 0);
+    ~FrameEncoder();
+    FrameEncoder(const FrameEncoder&) = delete;
+    FrameEncoder& operator=(const FrameEncoder&) = delete;
+
+    bool Ok() const { return !failed; } // false once opening or a write failed
+
+    // Copies one RGBA frame, bottom row first (as a render texture reads back)
+    void Submit(const void* pixels);
+
+    // Encodes what's left and closes the output; false when a write failed
+    bool Finish();
+
+    size_t FramesSubmitted() const { return framesSubmitted; }
+    size_t BytesWritten() const { return bytesWritten; }
+    size_t SegmentFrames() const { return segmentFrames; }
+
+private:
+    struct Segment {
+        size_t firstFrame;
+        size_t count;
+        std::vector<uint8_t> pixels; // segmentFrames frames
+        std::vector<uint8_t> encoded; // GIF: header + frames + trailer
+        bool done;
+        bool ok;
+    };
+
+    ExportFormat format;
+    std::string path;
+    int width, height;
+    float fps;
+    size_t frameBytes;
+    size_t segmentFrames;
+
+    FILE* gifFile = nullptr;
+    bool headerWritten = false;
+    size_t bytesWritten = 0;
+    size_t framesSubmitted = 0;
+    std::atomic<bool> failed{ false }; // set by the encoders
+
+    std::vector<std::unique_ptr<Segment>> segments; // all the buffers there are
+    std::vector<Segment*> freeSegments;
+    std::deque<Segment*> queued;  // waiting for an encoder
+    std::deque<Segment*> ordered; // submitted, oldest first, until written
+    Segment* filling = nullptr;
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable work;
+    std::condition_variable room;
+    bool stopping = false;
+    bool finished = false;
+
+    void SubmitSegment();
+    void EncoderLoop();
+    void Encode(Segment& segment);
+    void WriteFinished(); // with the mutex held
+    int CentisecondsFor(size_t frame) const;
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+// -----------------------------------------------------------------------------
+// Seconds the simulation advances this frame: GetFrameTime(), unless a fixed
+// step is set. Export mode fixes it, so a recording plays back at the same
+// pace however fast (or slowly) its frames were rendered.
+// -----------------------------------------------------------------------------
+float FrameTime();
+void SetFixedFrameTime(float seconds); // 0 goes back to the real frame time
@@ -0,0 +1,70 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+// How the main loop holds frames to the target rate; F5 switches
+enum PacingMode {
+    PACING_SLEEP,  // FramePacer: sleeps to absolute deadlines, never spins
+    PACING_RAYLIB, // SetTargetFPS: sleeps, then spins the last part of each frame
+    PACING_COUNT
+};
+
+const char* PacingName(PacingMode mode);
+
+// Frame timing over the recent frames. Jitter is how far each frame's length
+// was from the period, either way.
+struct PacingStats {
+    size_t frames;
+    double meanJitterMs;
+    double p99JitterMs;
+    double maxJitterMs;
+    size_t framesOver1Ms; // jitter above 1 ms
+    double cpuPercent;    // the pacing thread's CPU time over wall time
+};
+
+// -----------------------------------------------------------------------------
+// Paces frames by sleeping until absolute deadlines one period apart:
+// clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME) on POSIX, a high-resolution
+// waitable timer on Windows. A late wake-up doesn't push the deadlines back,
+// so the rate doesn't drift; after a stall of several periods they restart
+// from now rather than racing to catch up. Every frame boundary (Wait, or
+// Observe when something else paces) is recorded for the statistics.
+// -----------------------------------------------------------------------------
+class FramePacer {
+public:
+    static const size_t window = 300; // frames the statistics cover
+
+    explicit FramePacer(double fps = 60.0);
+    ~FramePacer();
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    void SetFps(double fps);
+    void Reset(); // the next Wait starts a new run of deadlines
+
+    void Wait();    // sleeps until the next deadline
+    void Observe(); // a frame ended, paced elsewhere
+
+    PacingStats Stats();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Clock::duration period;
+    Clock::time_point deadline;
+    bool started = false;
+
+    struct Sample {
+        Clock::time_point wall;
+        double cpuSeconds;
+    };
+    std::vector<Sample> samples; // ring of frame boundaries
+    size_t sampleCount = 0;
+    std::vector<double> sortedJitter; // reused by Stats
+
+    void* timer = nullptr; // Windows waitable timer
+
+    void SleepUntil(Clock::time_point when);
+    void Record(Clock::time_point now);
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+// -----------------------------------------------------------------------------
+// Generator<T>: a C++20 coroutine that produces values with co_yield.
+// Nothing runs until the first Next(); each Next() resumes the body up to its
+// next co_yield, so the caller decides the pace (one step per animation tick,
+// or all of them at once).
+// -----------------------------------------------------------------------------
+template <typename T>
+class Generator {
+public:
+    struct promise_type {
+        T current{};
+
+        Generator get_return_object() {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(T value) noexcept {
+            current = std::move(value);
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    Generator() = default;
+    Generator(Generator&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Generator& operator=(Generator&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+    ~Generator() {
+        if (handle) handle.destroy();
+    }
+
+    // Runs to the next co_yield; false once the body has returned
+    bool Next() {
+        if (!handle || handle.done()) return false;
+        handle.resume();
+        return !handle.done();
+    }
+
+    // The value from the last successful Next()
+    const T& Value() const { return handle.promise().current; }
+
+private:
+    explicit Generator(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+    std::coroutine_handle<promise_type> handle = nullptr;
+};
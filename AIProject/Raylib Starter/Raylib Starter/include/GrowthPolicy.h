@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+
+// How a dynamic array picks its next capacity when a push finds it full
+enum GrowthPolicy {
+    GROWTH_FIXED,  // never grows: pushes past the capacity are refused
+    GROWTH_1_5X,
+    GROWTH_2X,
+    GROWTH_EXACT,  // one more slot each time, so every push copies
+    GROWTH_COUNT
+};
+
+const char* GrowthPolicyName(GrowthPolicy policy);
+
+// Capacity after a push finds `capacity` slots full; at least one more slot
+// except for GROWTH_FIXED
+size_t GrowCapacity(GrowthPolicy policy, size_t capacity);
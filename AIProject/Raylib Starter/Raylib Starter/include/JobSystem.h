@@ -0,0 +1,104 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Work-stealing job system. Every worker owns a deque: it pushes and pops its
+// own jobs at the back while idle threads steal from the front of the others.
+// A thread waiting on jobs runs queued jobs instead of blocking, so a job can
+// start (and wait for) jobs of its own.
+// -----------------------------------------------------------------------------
+class JobSystem {
+public:
+    // `threads` includes the calling thread; 0 means one per hardware thread
+    explicit JobSystem(unsigned threads = 0);
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned ThreadCount() const { return (unsigned)workers.size() + 1; }
+
+    // Calls body(begin, end) over [0, count) in chunks of at least `grain`
+    // items spread across the pool; returns once every chunk has run
+    template <class Body>
+    void ParallelFor(size_t count, size_t grain, Body&& body);
+
+    // Runs a and b, possibly at the same time (fork-join)
+    template <class A, class B>
+    void ParallelInvoke(A&& a, B&& b) {
+        ParallelFor(2, 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                if (i == 0) a();
+                else b();
+            }
+        });
+    }
+
+private:
+    struct Job {
+        void (*run)(void* context, size_t begin, size_t end);
+        void* context;
+        size_t begin, end;
+        std::atomic<size_t>* pending;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void Push(const Job& job);
+    void WakeWorkers();
+    bool RunOne(); // runs a job from our own queue or a stolen one
+    void Wait(std::atomic<size_t>& pending);
+    void WorkerLoop(unsigned index);
+    unsigned QueueIndex() const;
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue>> queues; // [0] outside threads, [i + 1] worker i
+    std::atomic<size_t> queued{ 0 };
+    std::atomic<bool> stopping{ false };
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+};
+
+// Shared pool the visualizers use
+JobSystem& GetJobSystem();
+
+
+template <class Body>
+void JobSystem::ParallelFor(size_t count, size_t grain, Body&& body) {
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+
+    // A few chunks per thread leaves room for stealing to even out the load
+    size_t chunks = (count + grain - 1) / grain;
+    size_t maxChunks = (size_t)ThreadCount() * 4;
+    if (chunks > maxChunks) chunks = maxChunks;
+    if (chunks <= 1 || workers.empty()) {
+        body((size_t)0, count);
+        return;
+    }
+
+    using BodyType = std::remove_reference_t<Body>;
+    auto run = [](void* context, size_t begin, size_t end) {
+        (*static_cast<BodyType*>(context))(begin, end);
+    };
+    void* context = const_cast<void*>(static_cast<const void*>(&body));
+
+    std::atomic<size_t> pending{ chunks - 1 };
+    for (size_t c = 1; c < chunks; c++)
+        Push({ run, context, count * c / chunks, count * (c + 1) / chunks, &pending });
+    WakeWorkers();
+
+    // The caller takes the first chunk, then helps with the rest
+    body((size_t)0, count / chunks);
+    Wait(pending);
+}
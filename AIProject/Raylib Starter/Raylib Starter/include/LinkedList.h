@@ -1,5 +1,8 @@
 #pragma once
 #include "raylib.h"
+#include "CacheView.h"
+#include "NodePool.h"
+#include "TweenEngine.h"
 #include <vector>
 #include <string>
 #include "globals.h"
@@ -16,29 +19,15 @@ struct Node {
 };
 
 // -----------------------------------------------------------------------------
-// Animated node for smooth entry
-// -----------------------------------------------------------------------------
-struct AnimatedNode {
-    Node* node;
-    float targetY;
-
-    AnimatedNode(Node* n, float targetY);
-};
-
-// -----------------------------------------------------------------------------
-// Animated pointer (arrow animation between nodes)
+// Animated pointer (arrow animation between nodes); progress is tweened
 // -----------------------------------------------------------------------------
 struct AnimatedPointer {
     Vector2 start;
     Vector2 end;
-    Vector2 current;
-    bool active;
     float progress;
-    float speed;
 
     AnimatedPointer(Vector2 s, Vector2 e);
 
-    void Update();
     void Draw();
     bool IsFinished() const;
 };
@@ -54,15 +43,39 @@ public:
     void AddNode(int value);
     void InsertNodeAt(int index, int value);
     void DeleteLastNode();
+    void LoadValues(const std::vector<int>& values); // appends without the drop-in
 
     void UpdateAnimations();
     void Draw();
 
+    size_t Size() const { return nodes.size(); }
+    int ValueAt(size_t index) const { return nodes[index]->value; }
+
+    // Addresses one operation touches, element = list position. Search looks
+    // for `key`; insert walks to position `key`.
+    void TraceOperation(CacheTraceOp op, int key, AddressTrace& trace) const;
+    void DrawCacheLevels(const CacheView& view) const;
+
+    // Node storage: operator new (default) or a NodePool. Switching copies
+    // every node across in list order.
+    void SetPooled(bool pooled);
+    bool Pooled() const { return usePool; }
+    void CollectNodes(std::vector<const void*>& out) const; // list order
+    size_t FootprintBytes() const; // node storage including allocator overhead
+
+    // Follows the next links from head (benchmarks)
+    long long SumValues() const;
+
 private:
     Node* head;
+    NodePool<Node> pool;
+    bool usePool = false;
     std::vector<Node*> nodes;
-    std::vector<AnimatedNode> animatedNodes;
+    std::vector<Node*> droppingNodes; // relinked once they land
     std::vector<AnimatedPointer> animatedPointers;
+    TweenEngine tweens;
 
     void UpdateLinks();
+    Node* NewNode(int value, float x, float y);
+    void FreeNode(Node* node);
 };
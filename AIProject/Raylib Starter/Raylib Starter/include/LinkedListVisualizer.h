@@ -1,17 +1,29 @@
 #pragma once
 #include "raylib.h"
 #include "LinkedList.h"
+#include "MemoryLayoutView.h"
 
 class LinkedListVisualizer {
 public:
     LinkedListVisualizer();
     void Update();
+    void Tick(); // animations only, no input (multi-pane view)
     void Draw();
 
+    // The list's values, for rebuilding it in a new visualizer (the mode
+    // registry's compact and evict); input, views and animations start over
+    struct Snapshot {
+        std::vector<int> values;
+    };
+    Snapshot TakeSnapshot() const;
+    void Restore(const Snapshot& snapshot);
+
 private:
     LinkedList list;
     std::string inputValue, inputIndex;
     bool activeValueBox, activeIndexBox;
+    CacheView cacheView;
+    MemoryLayoutView memoryView;
 
     bool Button(Rectangle rect, const char* label, float uiScale);
     void DrawInputBox(Rectangle rect, std::string& input, bool active, float uiScale);
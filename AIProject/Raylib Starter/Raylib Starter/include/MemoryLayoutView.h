@@ -0,0 +1,57 @@
+#pragma once
+#include "raylib.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Address-space strip shared by the node-based visualizers. The structure
+// hands over its nodes in logical order; the view plots where each one lives
+// between the lowest and highest address, links logically adjacent nodes
+// (for small structures) and reports the gaps between them and what the
+// storage costs including allocator overhead. Its second button asks the
+// structure to move its nodes between operator new and a NodePool.
+// -----------------------------------------------------------------------------
+class MemoryLayoutView {
+public:
+    MemoryLayoutView(Vector2 origin, Rectangle strip);
+
+    // Handles the buttons; call once per frame
+    void HandleInput();
+
+    bool Active() const { return active; }
+    bool PoolRequested() const { return pooled; }
+
+    // True when the node addresses have to be collected again: the view was
+    // switched on, the node count changed or the storage moved
+    bool NeedsRefresh(size_t nodeCount);
+    void Invalidate() { dirty = true; }
+
+    // Cleared list for the structure to fill in logical order, then refresh
+    std::vector<const void*>& BeginCollect();
+    void Refresh(size_t nodeBytes, size_t footprintBytes);
+
+    void Draw() const; // buttons, and the strip and its numbers when active
+
+private:
+    static const size_t linkLimit = 256; // nodes beyond this get no links
+
+    Rectangle toggleButton;
+    Rectangle poolButton;
+    Rectangle strip;
+
+    bool active = false;
+    bool pooled = false;
+    bool dirty = true;
+    size_t lastCount = 0;
+
+    std::vector<const void*> nodes;
+    std::vector<uint32_t> columns;   // nodes per pixel column of the strip
+    uint32_t busiestColumn = 0;
+    std::vector<float> nodeX;        // strip x per node, up to linkLimit nodes
+    size_t nodeBytes = 0;
+    size_t footprintBytes = 0;
+    uintptr_t spanBytes = 0;
+    uintptr_t medianGap = 0;
+    float adjacentFraction = 0.0f;   // neighbours less than a cache line apart
+};
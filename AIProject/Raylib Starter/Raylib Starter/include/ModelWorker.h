@@ -0,0 +1,67 @@
+#pragma once
+#include "SpscQueue.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+// What a job on the model worker tells the render thread
+enum VisEventType : uint8_t {
+    VIS_BEGIN,          // a = number of events that follow, b/c are job specific
+    VIS_NODE_CREATED,   // a = node id, b = value
+    VIS_LINK_CHANGED,   // a = parent id (-1 for a new root), b = child id, c = 0 left / 1 right
+    VIS_HIGHLIGHT,      // a, b = indices (b = -1 for a single one)
+    VIS_VALUE_SET,      // a = index, b = value
+    VIS_VALUES_SWAPPED  // a, b = indices
+};
+
+struct VisEvent {
+    VisEventType type;
+    int32_t a;
+    int32_t b;
+    int32_t c;
+};
+
+// -----------------------------------------------------------------------------
+// Runs one data-structure job at a time on its own thread. The job works on
+// its own copy of the model and publishes VisEvents into an SPSC ring; the
+// render thread drains them at its own pace. When the ring is full the job
+// waits (back-pressure) instead of growing an unbounded backlog.
+// Everything except Publish/Cancelled is called from the render thread.
+// -----------------------------------------------------------------------------
+class ModelWorker {
+public:
+    explicit ModelWorker(size_t queueCapacity = 1 << 16);
+    ~ModelWorker();
+    ModelWorker(const ModelWorker&) = delete;
+    ModelWorker& operator=(const ModelWorker&) = delete;
+
+    // Starts job on a new thread; a job still running is cancelled first
+    void Run(std::function<void(ModelWorker&)> job);
+
+    // Stops the job at its next Publish and drops the events not yet drained
+    void Cancel();
+
+    // True while the job runs or its events are still queued
+    bool Busy() const;
+
+    // Waits until the job has returned or filled the queue, so what the next
+    // Drains see doesn't depend on how fast the job ran (scripted runs)
+    void WaitForOutput() const;
+    size_t Queued() const { return queue.Size(); }
+
+    // Applies at most `budget` queued events in order; returns how many
+    template <class Apply>
+    size_t Drain(size_t budget, Apply&& apply) { return queue.PopMany(budget, apply); }
+
+    // Worker side. Waits while the queue is full; false once the job has been
+    // cancelled and should return.
+    bool Publish(const VisEvent& event);
+    bool Cancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+private:
+    SpscQueue<VisEvent> queue;
+    std::thread thread;
+    std::atomic<bool> running{ false };
+    std::atomic<bool> cancelled{ false };
+};
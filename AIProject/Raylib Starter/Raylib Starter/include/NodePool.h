@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Slab allocator for one node type. Slots are carved out of blocks of
+// BlockSize in order, so nodes created one after another sit next to each
+// other in memory; destroyed slots go on a free list and are reused first.
+// Every node has to be destroyed before the pool goes away.
+// -----------------------------------------------------------------------------
+template <class T, size_t BlockSize = 256>
+class NodePool {
+public:
+    NodePool() = default;
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    template <class... Args>
+    T* Create(Args&&... args) {
+        Slot* slot = freeList;
+        if (slot) {
+            freeList = slot->next;
+        }
+        else {
+            if (carved == BlockSize) {
+                blocks.push_back(std::make_unique<Slot[]>(BlockSize));
+                carved = 0;
+            }
+            slot = &blocks.back()[carved++];
+        }
+        live++;
+        return new (slot->storage) T(std::forward<Args>(args)...);
+    }
+
+    void Destroy(T* node) {
+        node->~T();
+        Slot* slot = reinterpret_cast<Slot*>(node);
+        slot->next = freeList;
+        freeList = slot;
+        live--;
+    }
+
+    // Gives the blocks back once nothing lives in them
+    void Release() {
+        if (live > 0) return;
+        blocks.clear();
+        freeList = nullptr;
+        carved = BlockSize;
+    }
+
+    size_t Live() const { return live; }
+    size_t FootprintBytes() const { return blocks.size() * BlockSize * sizeof(Slot); }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> blocks;
+    Slot* freeList = nullptr;
+    size_t carved = BlockSize; // slots handed out from the newest block
+    size_t live = 0;
+};
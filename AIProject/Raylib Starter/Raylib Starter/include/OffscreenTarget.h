@@ -0,0 +1,34 @@
+#pragma once
+#include "raylib.h"
+
+// -----------------------------------------------------------------------------
+// Where the offscreen modes draw, in a window that's never shown. On the GPU
+// it's a render texture and the window is only there for the GL context. The
+// software renderer (GRAPHICS_API_OPENGL_11_SOFTWARE, raylib's rlsw) has no
+// framebuffer objects, so there it's the window's own framebuffer, sized to
+// the target; on SDL the offscreen video driver stands in for a display.
+// Scenes draw in screen coordinates (screenWidth x screenHeight), scaled.
+// -----------------------------------------------------------------------------
+class OffscreenTarget {
+public:
+    OffscreenTarget(float scale, const char* title); // opens the window
+    ~OffscreenTarget();                               // and closes it
+    OffscreenTarget(const OffscreenTarget&) = delete;
+    OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    static const char* BackendName();
+
+    void Begin(); // clears the target and applies the scale
+    void End();
+
+    // The frame just drawn, RGBA8; BottomUp says which way its rows run
+    Image Read();
+    static bool BottomUp();
+
+private:
+    int width, height;
+    Camera2D camera = {};
+    RenderTexture2D texture = {};
+};
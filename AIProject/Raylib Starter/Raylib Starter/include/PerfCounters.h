@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+
+enum PerfCounter {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,    // L1 data cache read misses
+    PERF_LLC_MISSES,    // last level cache read misses
+    PERF_BRANCH_MISSES,
+    PERF_COUNTER_COUNT
+};
+
+// -----------------------------------------------------------------------------
+// Hardware performance counters for the calling thread, read with Linux
+// perf_event_open. Each counter opens on its own, so a CPU or VM that lacks one
+// event still reports the others. Containers and other platforms usually
+// refuse them all; Open then returns false and Reason() says why.
+// -----------------------------------------------------------------------------
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool Open(); // true if at least one counter opened
+    bool Has(PerfCounter counter) const { return fds[counter] >= 0; }
+
+    void Start(); // zero and enable
+    void Stop();  // disable and read
+
+    // Count between Start and Stop, scaled up if the kernel had to multiplex
+    uint64_t Value(PerfCounter counter) const { return values[counter]; }
+
+    const char* Reason() const { return reason; }
+    static const char* Name(PerfCounter counter);
+
+private:
+    int fds[PERF_COUNTER_COUNT];
+    uint64_t values[PERF_COUNTER_COUNT];
+    const char* reason;
+};
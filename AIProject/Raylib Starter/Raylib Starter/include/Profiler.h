@@ -0,0 +1,93 @@
+#pragma once
+#include "AllocationTracker.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+enum ProfilePhase {
+    PHASE_INPUT,
+    PHASE_MODEL_UPDATE,
+    PHASE_LAYOUT,
+    PHASE_ANIMATION_TICK,
+    PHASE_DRAW,
+    PHASE_COUNT
+};
+
+struct FrameSample {
+    unsigned long long frame;
+    float frameMs;                // BeginFrame to EndFrame, including the vsync wait
+    float phaseMs[PHASE_COUNT];   // exclusive: a nested scope's time isn't counted twice
+
+    // Zero unless allocation tracking is on. Frame totals cover every thread,
+    // phases only the main thread.
+    uint32_t allocations;
+    uint32_t allocatedBytes;
+    uint32_t phaseAllocations[PHASE_COUNT];
+};
+
+// -----------------------------------------------------------------------------
+// Frame profiler. Scoped timers charge time (and allocations) to a phase;
+// EndFrame appends the frame's totals to a ring of samples. The ring has a
+// single writer (the main thread) and publishes through an atomic counter, so
+// readers never lock.
+// Scopes opened on other threads (job system workers) are ignored.
+// -----------------------------------------------------------------------------
+class Profiler {
+public:
+    static const size_t historySize = 1 << 14; // about 4.5 minutes at 60 FPS
+
+    Profiler();
+
+    void BeginFrame();
+    void EndFrame();
+
+    // Used by ProfileScope; false when the scope isn't recorded
+    bool Enter(ProfilePhase phase);
+    void Leave();
+
+    // Number of frames recorded so far (the ring holds the last historySize)
+    size_t FrameCount() const { return written.load(std::memory_order_acquire); }
+
+    // Copies the `count` most recent samples, oldest first; returns how many
+    size_t Recent(FrameSample* out, size_t count) const;
+
+    bool WriteCsv(const char* path) const;
+
+    static const char* PhaseName(ProfilePhase phase);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<FrameSample> ring;
+    std::atomic<size_t> written{ 0 };
+
+    std::thread::id owner;
+    Clock::time_point frameStart;
+    Clock::time_point lastSwitch;
+    AllocationStats frameStartAllocations = {};
+    uint64_t lastSwitchAllocations = 0;
+    double phaseSeconds[PHASE_COUNT] = {};
+    uint64_t phaseAllocations[PHASE_COUNT] = {};
+    ProfilePhase stack[16];
+    int depth = 0;
+
+    void ChargeOpenScope(Clock::time_point now);
+};
+
+Profiler& GetProfiler();
+
+// Charges the time until the end of the enclosing block to `phase`
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfilePhase phase) : active(GetProfiler().Enter(phase)) {}
+    ~ProfileScope() {
+        if (active) GetProfiler().Leave();
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    bool active;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+// -----------------------------------------------------------------------------
+// Render mode: "Raylib Starter.exe --render <scenario> [--frames N]
+//     [--scale S] [--every K] [--save folder | --compare folder]
+//     [--tolerance T]"
+// Draws N frames of a scripted scenario (Scenario.h) offscreen as fast as it
+// can and reports the time per frame spent drawing, for draw-path benchmarks.
+// Every Kth frame and the last are checkpoints: --save writes them as golden
+// PNGs, --compare diffs them against the saved ones pixel by pixel (allowing
+// T per channel), fails on any difference and leaves a .diff.png marking it.
+// A build on the software renderer needs no display or GPU, and its goldens
+// don't depend on a driver.
+// -----------------------------------------------------------------------------
+int RunRender(int argc, char** argv);
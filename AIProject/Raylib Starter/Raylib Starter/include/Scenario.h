@@ -0,0 +1,27 @@
+#pragma once
+#include "ArrayVisualizer.h"
+#include "BinaryTree.h"
+#include "LinkedList.h"
+
+// Everything a scenario can drive; only the structure it uses is drawn
+struct ScenarioScene {
+    LinkedList list;
+    BinaryTree tree{ screenWidth, screenHeight };
+    ArrayVisualizer array{ screenWidth, screenHeight };
+};
+
+// -----------------------------------------------------------------------------
+// Scripted runs for the export and render modes. Each drives one structure
+// through a fixed sequence of operations, triggered on frame numbers, and
+// animates it by one step per frame; with a fixed step (SetFixedFrameTime)
+// every run draws the same frames.
+// -----------------------------------------------------------------------------
+struct Scenario {
+    const char* name;
+    int frames; // at 60 fps
+    void (*step)(ScenarioScene& scene, int frame);
+    void (*draw)(ScenarioScene& scene);
+};
+
+const Scenario* FindScenario(const char* name); // null when there's none
+void PrintScenarioNames();
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstddef>
+
+// -----------------------------------------------------------------------------
+// Untraced fast paths for the array engine. Both pick AVX2, SSE4.1 or scalar
+// code at runtime from GetCpuFeatures().
+// -----------------------------------------------------------------------------
+
+// LSD radix sort, 8 bits per pass. Every pass counts and scatters slices on
+// their own threads (per-thread histograms) through write-combining buffers
+// flushed with vector stores. Passes where all keys share a digit are skipped.
+void RadixSortParallel(int* data, size_t count);
+
+// Quicksort whose partition step compares 8 (AVX2) or 4 (SSE4.1) keys at a
+// time and compacts them with a permutation table, partitioning back and forth
+// between the data and a scratch buffer.
+void QuickSortVectorized(int* data, size_t count);
+
+// Name of the instruction set the kernels will use on this CPU
+const char* SortKernelIsa();
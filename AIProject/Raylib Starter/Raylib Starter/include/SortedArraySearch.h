@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Memory layouts for the same set of sorted keys
+enum SearchLayout { LAYOUT_SORTED, LAYOUT_EYTZINGER, LAYOUT_BTREE, LAYOUT_COUNT };
+
+// Search kernels. SIMD picks AVX2 or SSE4.1 at runtime and falls back to the
+// branchless kernel when neither is available.
+enum SearchKernel { KERNEL_BRANCHLESS, KERNEL_SIMD, KERNEL_COUNT };
+
+// One step of a search, as slots of the layout's array (a B-tree step reads a whole block)
+struct SearchProbe {
+    int slot;
+    int count;
+};
+
+// -----------------------------------------------------------------------------
+// Lower-bound search over sorted, Eytzinger (BFS order) and blocked B-tree
+// layouts of the same keys. Results are slots of the chosen layout's array,
+// holding the first key >= the query, or -1 when every key is smaller.
+// -----------------------------------------------------------------------------
+class SortedArraySearch {
+public:
+    static const int blockSize = 16; // keys per B-tree block (one cache line)
+
+    void Build(const std::vector<int>& keys);
+
+    int Find(int value, SearchLayout layout, SearchKernel kernel) const;
+    void FindBatch(const int* values, int* slots, size_t count, SearchLayout layout, SearchKernel kernel) const;
+
+    // Times FindBatch over the queries
+    double MeasureNsPerLookup(const std::vector<int>& queries, SearchLayout layout, SearchKernel kernel) const;
+
+    // Probe sequence of the branchless kernel, for animation
+    void Trace(int value, SearchLayout layout, std::vector<SearchProbe>& probes) const;
+
+    // Cell contents of a layout (the first Cells() entries are meaningful)
+    const int* Data(SearchLayout layout) const;
+    int Cells(SearchLayout layout) const;
+    int Size() const { return n; }
+
+    static const char* LayoutName(SearchLayout layout);
+    static const char* KernelName(SearchKernel kernel); // names the ISA actually used
+
+private:
+    int n = 0;
+    int btreeBlocks = 0;
+    std::vector<int> sorted;    // padded with INT_MAX so SIMD loads may overrun
+    std::vector<int> eytzinger; // 1-based, slot 0 unused
+    std::vector<int> btreeStorage;
+    int* btree = nullptr;       // 64-byte aligned view into btreeStorage
+
+    int EytzingerBuild(int i, int k);
+    void BTreeBuild(int k, int& next);
+
+    int FindSorted(int value) const;
+    int FindEytzinger(int value) const;
+    int FindBTree(int value) const;
+    int FindSortedSimd(int value) const;
+    int FindBTreeSimd(int value) const;
+    void FindEytzingerSimdBatch(const int* values, int* slots, size_t count) const;
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+enum SortAlgorithm {
+    SORT_INSERTION,
+    SORT_MERGE,
+    SORT_INTROSORT,
+    SORT_HEAP,
+    SORT_RADIX,
+    SORT_PARALLEL_MERGE,
+    SORT_COUNT
+};
+
+// -----------------------------------------------------------------------------
+// Sort trace: every compare/swap/write an algorithm made, in order.
+// Replaying the swaps and writes on a copy of the input reproduces the sort.
+// -----------------------------------------------------------------------------
+enum SortOp : uint8_t { SORT_OP_COMPARE, SORT_OP_SWAP, SORT_OP_WRITE };
+
+struct SortEvent {
+    uint32_t index;
+    int32_t other; // second index for compare/swap, value for write
+    SortOp op;
+};
+
+struct SortTrace {
+    std::vector<SortEvent> events;
+    size_t compares = 0;
+    size_t swaps = 0;
+    size_t writes = 0;
+
+    void Clear();
+};
+
+// Sorts ascending. With a trace the algorithm records every step (parallel
+// merge sort records per thread and concatenates); without one it runs the
+// same code at full speed.
+void Sort(SortAlgorithm algorithm, int* data, size_t count, SortTrace* trace = nullptr);
+
+// Hands every step to `sink` as the algorithm makes it instead of storing the
+// trace, so memory stays flat however long the sort runs. Parallel merge sort
+// runs on one thread here, to keep the steps in order. A sink returning false
+// stops the sort where it is (data is left part sorted); returns false then.
+using SortSink = std::function<bool(const SortEvent&)>;
+bool SortStreamed(SortAlgorithm algorithm, int* data, size_t count, const SortSink& sink);
+
+const char* SortName(SortAlgorithm algorithm);
@@ -0,0 +1,130 @@
+#pragma once
+#include "Cpu.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Paged sparse array. Slots live in pages of PageSize that are allocated the
+// first time one of their slots is written; each page keeps a bitmap of which
+// slots hold a value. Writing slot 5,000,000 costs one page, not five million
+// placeholders, and walking the occupied slots skips missing pages and empty
+// bitmap words. Slots never move once written, so pointers into them stay
+// valid until Clear (an erased slot's storage stays in its page).
+// -----------------------------------------------------------------------------
+template <class T, size_t PageSize = 4096>
+class SparseArray {
+public:
+    static_assert(PageSize % 64 == 0, "pages hold whole bitmap words");
+
+    // One past the highest occupied slot
+    size_t Size() const { return size; }
+    size_t OccupiedCount() const { return occupied; }
+    size_t PageCount() const { return pageCount; }
+    size_t FootprintBytes() const { return pageCount * sizeof(Page) + pages.capacity() * sizeof(pages[0]); }
+
+    bool Occupied(size_t i) const {
+        const Page* page = PageOf(i);
+        return page && ((page->bits[(i % PageSize) / 64] >> (i % 64)) & 1);
+    }
+
+    // The value in slot i, or null when nothing was written there
+    T* Find(size_t i) { return Occupied(i) ? &pages[i / PageSize]->slots[i % PageSize] : nullptr; }
+    const T* Find(size_t i) const { return Occupied(i) ? &pages[i / PageSize]->slots[i % PageSize] : nullptr; }
+
+    // Stores value in slot i, allocating its page on first use
+    T& Set(size_t i, const T& value) {
+        size_t p = i / PageSize;
+        if (p >= pages.size()) pages.resize(p + 1);
+        if (!pages[p]) {
+            pages[p] = std::make_unique<Page>();
+            pageCount++;
+        }
+
+        Page& page = *pages[p];
+        uint64_t& word = page.bits[(i % PageSize) / 64];
+        uint64_t bit = (uint64_t)1 << (i % 64);
+        if (!(word & bit)) {
+            word |= bit;
+            occupied++;
+        }
+        if (i >= size) size = i + 1;
+        return page.slots[i % PageSize] = value;
+    }
+
+    // Empties slot i; erasing the last occupied slot shrinks Size() back to the
+    // one before it
+    void Erase(size_t i) {
+        if (!Occupied(i)) return;
+        pages[i / PageSize]->bits[(i % PageSize) / 64] &= ~((uint64_t)1 << (i % 64));
+        occupied--;
+        if (i + 1 < size) return;
+        while (size > 0) {
+            size_t last = size - 1;
+            const Page* page = PageOf(last);
+            if (!page) {
+                size = last / PageSize * PageSize; // skip the whole missing page
+                continue;
+            }
+            uint64_t word = page->bits[(last % PageSize) / 64] & (~(uint64_t)0 >> (63 - last % 64));
+            if (word) {
+                size = last / 64 * 64 + HighestSetBit64(word) + 1;
+                break;
+            }
+            size = last / 64 * 64;
+        }
+    }
+
+    // First occupied slot in [i, end), or end (at most Size()) when there is none
+    size_t NextOccupied(size_t i, size_t end = SIZE_MAX) const {
+        if (end > size) end = size;
+        while (i < end) {
+            const Page* page = PageOf(i);
+            if (!page) {
+                i = (i / PageSize + 1) * PageSize; // skip the whole missing page
+                continue;
+            }
+            size_t w = (i % PageSize) / 64;
+            uint64_t word = page->bits[w] & (~(uint64_t)0 << (i % 64));
+            if (word) {
+                size_t found = i / 64 * 64 + LowestSetBit64(word);
+                return found < end ? found : end;
+            }
+            i = (i / 64 + 1) * 64;
+        }
+        return end;
+    }
+
+    void Clear() {
+        pages.clear();
+        pages.shrink_to_fit();
+        size = occupied = pageCount = 0;
+    }
+
+private:
+    struct Page {
+        T slots[PageSize];
+        uint64_t bits[PageSize / 64] = {};
+    };
+
+    const Page* PageOf(size_t i) const {
+        size_t p = i / PageSize;
+        return p < pages.size() ? pages[p].get() : nullptr;
+    }
+
+    static int LowestSetBit64(uint64_t x) {
+        unsigned int low = (unsigned int)x;
+        return low ? CountTrailingZeros(low) : 32 + CountTrailingZeros((unsigned int)(x >> 32));
+    }
+
+    static int HighestSetBit64(uint64_t x) {
+        unsigned int high = (unsigned int)(x >> 32);
+        return high ? 32 + HighestSetBit(high) : HighestSetBit((unsigned int)x);
+    }
+
+    std::vector<std::unique_ptr<Page>> pages; // null until a slot in the page is written
+    size_t size = 0;
+    size_t occupied = 0;
+    size_t pageCount = 0;
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Lock-free single-producer / single-consumer ring buffer. One thread pushes,
+// one other thread pops, and neither ever blocks. Head and tail sit on their
+// own cache lines and each side keeps a cached copy of the other's index, so
+// the shared line is only read when the ring looks full (or empty).
+// -----------------------------------------------------------------------------
+template <typename T>
+class SpscQueue {
+public:
+    // Capacity is rounded up to a power of two
+    explicit SpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size *= 2;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side. False when the ring is full.
+    bool TryPush(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead > mask) return false;
+        }
+        slots[t & mask] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. False when the ring is empty.
+    bool TryPop(T& item) {
+        return PopMany(1, [&](const T& value) { item = value; }) == 1;
+    }
+
+    // Consumer side: hands up to `max` items to `consume` in order and frees
+    // their slots with a single store. Returns how many were consumed.
+    template <class Consume>
+    size_t PopMany(size_t max, Consume&& consume) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (cachedTail - h < max) cachedTail = tail.load(std::memory_order_acquire);
+        size_t available = cachedTail - h;
+        size_t count = available < max ? available : max;
+        for (size_t i = 0; i < count; i++) consume(slots[(h + i) & mask]);
+        if (count) head.store(h + count, std::memory_order_release);
+        return count;
+    }
+
+    // Approximate when called while the other side is running
+    size_t Size() const {
+        size_t h = head.load(std::memory_order_acquire);
+        return tail.load(std::memory_order_acquire) - h;
+    }
+    size_t Capacity() const { return mask + 1; }
+
+private:
+    std::vector<T> slots;
+    size_t mask;
+
+    alignas(64) std::atomic<size_t> head{ 0 }; // next slot to pop, written by the consumer
+    size_t cachedTail = 0;                     // consumer's last view of tail
+    alignas(64) std::atomic<size_t> tail{ 0 }; // next slot to fill, written by the producer
+    size_t cachedHead = 0;                     // producer's last view of head
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include "NodePool.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One node of a stored tree version. Versions share nodes, so a node is never
+// changed once another version can reach it. `id` names the on-screen node it
+// stands for and is kept by every copy made of it.
+struct VersionNode {
+    int value;
+    uint32_t id;
+    uint32_t refs;  // parents and version roots pointing here
+    uint32_t edit;  // the edit that made it; only that edit may change it
+    VersionNode* left;
+    VersionNode* right;
+};
+
+// What made a version, for the timeline
+enum TreeVersionOp {
+    TREE_OP_EMPTY,
+    TREE_OP_INSERT,
+    TREE_OP_DELETE,
+    TREE_OP_LOAD, // InsertImmediate and bulk insert: many keys, one version
+};
+
+struct TreeVersion {
+    VersionNode* root;
+    size_t nodeCount;
+    TreeVersionOp op;
+    int value;
+};
+
+// -----------------------------------------------------------------------------
+// Persistent binary search tree: every edit makes a new version that copies
+// the root-to-leaf paths it changes and shares everything else with the
+// version before it, so a version costs O(depth) nodes and switching to one is
+// a pointer swap. Nodes made during the open edit are changed in place, so a
+// load of many keys copies each path once. Nodes are reference counted and
+// freed when the last version using them goes (an edit after an undo drops
+// the redo versions). Same descent as BinaryTree: duplicates go right.
+// -----------------------------------------------------------------------------
+class TreeHistory {
+public:
+    TreeHistory();
+    ~TreeHistory();
+    TreeHistory(const TreeHistory&) = delete;
+    TreeHistory& operator=(const TreeHistory&) = delete;
+
+    // Starts a version after the current one, dropping any versions after it
+    void BeginEdit(TreeVersionOp op, int value);
+    void EndEdit();
+    bool Editing() const { return editing; }
+    TreeVersionOp EditOp() const { return versions.back().op; }
+
+    // Inside an edit. Insert returns the new node's id; Remove returns false
+    // when the value isn't there, else the id of the node that left the tree
+    // (a node with two children takes its successor's value and id)
+    uint32_t Insert(int value);
+    bool Remove(int value, uint32_t* removedId);
+
+    // Versions; 0 is the empty tree. Selecting one keeps the others.
+    size_t VersionCount() const { return versions.size(); }
+    size_t Current() const { return current; }
+    const TreeVersion& Version(size_t i) const { return versions[i]; }
+    const VersionNode* Root() const { return versions[current].root; }
+    void Select(size_t version);
+
+    // Pairs up the two trees position by position, skipping shared subtrees,
+    // including one that moved up or down a level whole (a one-child delete
+    // or its undo). A node left in `leaving` but not in `entering` is not in
+    // `to`; entering nodes come parents first.
+    static void Diff(const VersionNode* from, const VersionNode* to,
+        std::vector<const VersionNode*>& leaving, std::vector<const VersionNode*>& entering);
+
+    size_t StoredNodes() const { return pool.Live(); }
+    size_t SnapshotNodes() const; // what a full copy per version would store
+    size_t FootprintBytes() const { return pool.FootprintBytes() + versions.capacity() * sizeof(TreeVersion); }
+
+private:
+    NodePool<VersionNode> pool;
+    std::vector<TreeVersion> versions;
+    size_t current = 0;
+    bool editing = false;
+    uint32_t editStamp = 0;
+    uint32_t nextId = 0;
+    std::vector<VersionNode*> releaseStack; // reused by Release
+
+    VersionNode* Own(VersionNode*& link);   // a copy this edit may change
+    void Release(VersionNode* node);
+};
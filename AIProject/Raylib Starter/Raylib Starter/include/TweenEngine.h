@@ -0,0 +1,65 @@
+#pragma once
+#include "raylib.h"
+#include "JobSystem.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+enum Easing : uint8_t {
+    EASE_LINEAR,
+    EASE_OUT_QUAD,
+    EASE_OUT_CUBIC
+};
+
+// -----------------------------------------------------------------------------
+// Tween engine. Every active tween drives one float (an object's property) from
+// where it was when the tween started to an end value. Tweens live in parallel
+// arrays, one entry per active tween, so a tick is a single pass over the
+// arrays and costs nothing when nothing moves; finished tweens are
+// swap-removed. Tweens are added and ticked on the main thread only.
+// The tick kernel advances 8 (AVX2) or 4 (SSE4.1) tweens at a time, easing
+// included, and marks settled tweens in a bitmask that removal then walks.
+// -----------------------------------------------------------------------------
+class TweenEngine {
+public:
+    // Moves *target from its current value to `to`. A tween already driving
+    // target is replaced; duration 0 just sets the value.
+    void Add(float* target, float to, float duration, Easing easing = EASE_OUT_QUAD);
+
+    // Advances every tween by dt; large sets are split across `jobs`
+    void Tick(float dt, JobSystem& jobs = GetJobSystem());
+
+    void Cancel(float* target);                          // leaves the value where it is
+    void CancelRange(const void* begin, size_t bytes);   // every target inside an object
+    void FinishAll();                                    // jumps every target to its end value
+    void Clear();                                        // drops every tween in place
+
+    // Targets inside [oldBase, oldBase + bytes) moved to newBase, e.g. when a
+    // vector of animated elements reallocates
+    void Rebase(const void* oldBase, size_t bytes, void* newBase);
+
+    bool Active(const float* target) const { return index.count(target) != 0; }
+    size_t Count() const { return targets.size(); }
+
+    // Benchmarks: tick with the scalar kernel even where SIMD is available
+    void SetScalarKernel(bool scalar) { scalarKernel = scalar; }
+
+    // Instruction set the tick kernel uses on this CPU
+    static const char* KernelIsa();
+
+private:
+    std::vector<float*> targets;
+    std::vector<float> starts;
+    std::vector<float> ends;
+    std::vector<float> progress; // 0..1
+    std::vector<float> rates;    // progress per second (1 / duration)
+    std::vector<uint8_t> easings;
+    std::unordered_map<const float*, uint32_t> index; // target -> slot
+    std::vector<uint32_t> settled; // bit i: tween i reached its end this tick
+    bool scalarKernel = false;
+
+    void RemoveAt(size_t i);
+};
+
+Color LerpColor(Color from, Color to, float t);
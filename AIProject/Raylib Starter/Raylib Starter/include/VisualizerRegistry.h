@@ -0,0 +1,71 @@
+#pragma once
+#include "ArrayVisualizer.h"
+#include "BinaryTreeVisualizer.h"
+#include "LinkedListVisualizer.h"
+#include <memory>
+
+enum AppMode { MENU, LINKED_LIST, BINARY_TREE, ARRAY, ALL_PANES };
+
+// What happens to a visualizer when the modes showing it are left
+enum LeavePolicy {
+    LEAVE_KEEP,    // stays as it is
+    LEAVE_COMPACT, // rebuilt from its snapshot at once: same contents, none of the history, caches or spare storage
+    LEAVE_EVICT    // only the snapshot stays; rebuilt from it on the next entry
+};
+
+// -----------------------------------------------------------------------------
+// A visualizer made the first time it's asked for. V provides a Snapshot
+// type, TakeSnapshot() and Restore(snapshot), which fills a freshly made V.
+// A snapshot holds plain values, so an evicted structure costs its contents
+// and nothing else.
+// -----------------------------------------------------------------------------
+template <class V>
+class LazyVisualizer {
+public:
+    using Create = std::unique_ptr<V>(*)();
+
+    LazyVisualizer(Create create, LeavePolicy policy) : create(create), policy(policy) {}
+
+    // Makes the visualizer, or rebuilds it from its snapshot
+    V& Get() {
+        if (!visualizer) {
+            visualizer = create();
+            if (snapshot) {
+                visualizer->Restore(*snapshot);
+                snapshot.reset();
+            }
+        }
+        return *visualizer;
+    }
+
+    void Leave() {
+        if (!visualizer || policy == LEAVE_KEEP) return;
+        snapshot = std::make_unique<typename V::Snapshot>(visualizer->TakeSnapshot());
+        visualizer.reset(); // before rebuilding, so both never coexist
+        if (policy == LEAVE_COMPACT) Get();
+    }
+
+    const char* StateName() const { return visualizer ? "live" : snapshot ? "snapshot" : "not loaded"; }
+
+private:
+    Create create;
+    LeavePolicy policy;
+    std::unique_ptr<V> visualizer;
+    std::unique_ptr<typename V::Snapshot> snapshot; // while evicted
+};
+
+// -----------------------------------------------------------------------------
+// The menu's visualizers. Nothing is made at startup; a mode makes what it
+// shows when it's first entered (all three for ALL_PANES), and Switch applies
+// the leave policy to whatever the new mode doesn't show.
+// -----------------------------------------------------------------------------
+class VisualizerRegistry {
+public:
+    VisualizerRegistry();
+
+    LazyVisualizer<LinkedListVisualizer> list;
+    LazyVisualizer<BinaryTreeVisualizer> tree;
+    LazyVisualizer<ArrayVisualizer> array;
+
+    void Switch(AppMode from, AppMode to);
+};
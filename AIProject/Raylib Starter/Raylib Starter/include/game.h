@@ -1,15 +1,31 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include "FramePacer.h"
+#include "Profiler.h"
+#include <vector>
+
 class Game
 {
 public:
     void init();
     void draw();
     void update();
+    void endFrame(); // after EndDrawing: holds the frame rate
+    void shutdown();
 
 private:
-    
+    bool showProfiler = false;             // F3 toggles the overlay
+    std::vector<FrameSample> recentFrames; // reused every frame
+    std::vector<float> sortedFrameMs;
+
+    static const int targetFps = 60;
+    PacingMode pacing = PACING_SLEEP; // F5 switches
+    FramePacer pacer;
+
+    void applyPacing();
+
+    void drawProfiler();
 };
 
 #endif // GAME_H
@@ -0,0 +1,145 @@
+#include "AllocationTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+static std::atomic<bool> trackingEnabled{ false };
+static std::atomic<uint64_t> totalAllocations{ 0 };
+static std::atomic<uint64_t> totalFrees{ 0 };
+static std::atomic<uint64_t> totalBytes{ 0 };
+static thread_local AllocationStats threadStats = {};
+
+void SetAllocationTracking(bool enabled) {
+    trackingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool AllocationTrackingEnabled() {
+    return trackingEnabled.load(std::memory_order_relaxed);
+}
+
+AllocationStats GetAllocationStats() {
+    return { totalAllocations.load(std::memory_order_relaxed),
+        totalFrees.load(std::memory_order_relaxed),
+        totalBytes.load(std::memory_order_relaxed) };
+}
+
+AllocationStats GetThreadAllocationStats() {
+    return threadStats;
+}
+
+size_t AllocationFootprint(const void* p, size_t requested) {
+    // glibc and the Windows heap both keep one word in front of a small chunk
+    const size_t header = sizeof(void*);
+#if defined(_MSC_VER)
+    (void)requested;
+    return _msize(const_cast<void*>(p)) + header;
+#elif defined(__GLIBC__)
+    (void)requested;
+    return malloc_usable_size(const_cast<void*>(p)) + header;
+#else
+    (void)p;
+    return requested + header;
+#endif
+}
+
+static void CountAllocation(size_t size) {
+    if (!trackingEnabled.load(std::memory_order_relaxed)) return;
+    totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(size, std::memory_order_relaxed);
+    threadStats.allocations++;
+    threadStats.bytes += size;
+}
+
+static void CountFree(void* p) {
+    if (!p || !trackingEnabled.load(std::memory_order_relaxed)) return;
+    totalFrees.fetch_add(1, std::memory_order_relaxed);
+    threadStats.frees++;
+}
+
+static void* Allocate(size_t size) {
+    CountAllocation(size);
+    return malloc(size ? size : 1);
+}
+
+static void* AllocateAligned(size_t size, size_t alignment) {
+    CountAllocation(size);
+    if (size == 0) size = 1;
+#ifdef _MSC_VER
+    return _aligned_malloc(size, alignment);
+#else
+    // aligned_alloc wants a size that is a multiple of the alignment
+    return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+static void Free(void* p) {
+    CountFree(p);
+    free(p);
+}
+
+static void FreeAligned(void* p) {
+    CountFree(p);
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Replacements for every global operator new/delete
+// -----------------------------------------------------------------------------
+void* operator new(size_t size) {
+    void* p = Allocate(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    void* p = Allocate(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    void* p = AllocateAligned(size, (size_t)alignment);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    void* p = AllocateAligned(size, (size_t)alignment);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return AllocateAligned(size, (size_t)alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return AllocateAligned(size, (size_t)alignment);
+}
+
+void operator delete(void* p) noexcept { Free(p); }
+void operator delete[](void* p) noexcept { Free(p); }
+void operator delete(void* p, size_t) noexcept { Free(p); }
+void operator delete[](void* p, size_t) noexcept { Free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { Free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { Free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(p); }
@@ -0,0 +1,180 @@
+#include "ArrayChart.h"
+#include <algorithm>
+
+ArrayChart::ArrayChart(Rectangle bounds)
+    : bounds(bounds), width((int)bounds.width), height((int)bounds.height) {
+    sums.assign(width, 0);
+    pixels.assign((size_t)width * height, RAYWHITE);
+    dirty.assign(width, 0);
+}
+
+ArrayChart::~ArrayChart() {
+    // After CloseWindow the texture went with the GL context
+    if (texture.id != 0 && IsWindowReady()) UnloadTexture(texture);
+}
+
+void ArrayChart::SetMode(ChartMode newMode) {
+    mode = newMode;
+    allDirty = true;
+}
+
+// -----------------------------------------------------------------------------
+// Columns and elements. With count >= width, column c holds the elements
+// [ceil(c * count / width), ceil((c + 1) * count / width)); otherwise element i
+// covers the columns [ceil(i * width / count), ceil((i + 1) * width / count)).
+// -----------------------------------------------------------------------------
+static size_t CeilDiv(uint64_t a, uint64_t b) {
+    return (size_t)((a + b - 1) / b);
+}
+
+void ArrayChart::ColumnsOf(size_t index, size_t& first, size_t& last) const {
+    if (count >= (size_t)width) {
+        first = (size_t)((uint64_t)index * width / count);
+        last = first + 1;
+    }
+    else {
+        first = CeilDiv((uint64_t)index * width, count);
+        last = CeilDiv((uint64_t)(index + 1) * width, count);
+    }
+}
+
+size_t ArrayChart::ElementsIn(size_t column) const {
+    if (count < (size_t)width) return 1;
+    return CeilDiv((uint64_t)(column + 1) * count, width) - CeilDiv((uint64_t)column * count, width);
+}
+
+void ArrayChart::Reset(size_t newCount) {
+    count = newCount;
+    std::fill(sums.begin(), sums.end(), 0);
+    minValue = maxValue = 0;
+    allDirty = true;
+}
+
+void ArrayChart::Add(size_t index, int value) {
+    if (index >= count) return;
+    size_t first, last;
+    ColumnsOf(index, first, last);
+    for (size_t c = first; c < last; c++) sums[c] += value;
+    Extend(value);
+}
+
+void ArrayChart::Write(size_t index, int oldValue, int newValue) {
+    if (index >= count || oldValue == newValue) return;
+    size_t first, last;
+    ColumnsOf(index, first, last);
+    for (size_t c = first; c < last; c++) {
+        sums[c] += (int64_t)newValue - oldValue;
+        MarkDirty(c);
+    }
+    // A wider range rescales every column
+    if (Extend(newValue)) allDirty = true;
+}
+
+void ArrayChart::MarkDirty(size_t column) {
+    if (dirty[column]) return;
+    dirty[column] = 1;
+    dirtyColumns.push_back((int)column);
+}
+
+bool ArrayChart::Extend(int value) {
+    if (value >= minValue && value <= maxValue) return false;
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Redraw and upload
+// -----------------------------------------------------------------------------
+void ArrayChart::DrawColumn(int x) {
+    size_t elements = ElementsIn(x);
+    float mean = elements > 0 && count > 0 ? (float)sums[x] / elements : 0.0f;
+
+    // Zero sits where the range puts it; bars grow up or down from there
+    float range = (float)std::max(1, maxValue - minValue);
+    float level = (mean - minValue) / range; // 0..1
+    if (mode == CHART_HEATMAP) {
+        Color color = count > 0 ? ColorFromHSV(240.0f * (1.0f - level), 0.75f, 0.95f) : RAYWHITE;
+        for (int y = 0; y < height; y++) pixels[(size_t)y * width + x] = color;
+        return;
+    }
+
+    int zeroY = (int)(height * (float)maxValue / range);
+    int valueY = (int)(height * (1.0f - level));
+    int top = std::min(zeroY, valueY), bottom = std::max(zeroY, valueY);
+    if (count > 0 && bottom == top) bottom = top + 1; // keep zeros visible as a line
+    for (int y = 0; y < height; y++)
+        pixels[(size_t)y * width + x] = (y >= top && y < bottom) ? SKYBLUE : RAYWHITE;
+}
+
+void ArrayChart::Update() {
+    if (allDirty) {
+        for (int x = 0; x < width; x++) DrawColumn(x);
+        for (int column : dirtyColumns) dirty[column] = 0;
+        dirtyColumns.clear();
+        pendingRuns.clear();
+        pendingFull = true;
+        allDirty = false;
+        return;
+    }
+    if (dirtyColumns.empty()) return;
+
+    // Neighbouring columns go up together
+    std::sort(dirtyColumns.begin(), dirtyColumns.end());
+    for (int column : dirtyColumns) {
+        DrawColumn(column);
+        dirty[column] = 0;
+        if (!pendingRuns.empty() && pendingRuns.back().x + pendingRuns.back().columns == column)
+            pendingRuns.back().columns++;
+        else
+            pendingRuns.push_back({ column, 1 });
+    }
+    dirtyColumns.clear();
+}
+
+void ArrayChart::Draw() {
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    // The software renderer has no glTexSubImage2D (UpdateTexture does
+    // nothing there), so any change reloads the whole texture
+    if (texture.id != 0 && (pendingFull || !pendingRuns.empty())) {
+        UnloadTexture(texture);
+        texture = {};
+    }
+#endif
+    if (texture.id == 0) {
+        Image image = { pixels.data(), width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+        texture = LoadTextureFromImage(image);
+        uploadedColumns = width;
+        uploadCalls = 1;
+    }
+    // Several runs from one frame can land in the same upload; past a point a
+    // single full upload is cheaper than many small ones
+    else if (pendingFull || (int)pendingRuns.size() > fullUploadRuns) {
+        UpdateTexture(texture, pixels.data());
+        uploadedColumns = width;
+        uploadCalls = 1;
+    }
+    else if (!pendingRuns.empty()) {
+        uploadedColumns = 0;
+        uploadCalls = (int)pendingRuns.size();
+        for (const Run& run : pendingRuns) {
+            staging.resize((size_t)run.columns * height);
+            for (int y = 0; y < height; y++)
+                std::copy_n(&pixels[(size_t)y * width + run.x], run.columns, &staging[(size_t)y * run.columns]);
+            UpdateTextureRec(texture, { (float)run.x, 0, (float)run.columns, (float)height }, staging.data());
+            uploadedColumns += run.columns;
+        }
+    }
+    else {
+        uploadedColumns = uploadCalls = 0;
+    }
+    pendingRuns.clear();
+    pendingFull = false;
+
+    DrawTexture(texture, (int)bounds.x, (int)bounds.y, WHITE);
+    DrawRectangleLinesEx(bounds, 1, GRAY);
+    DrawText(TextFormat("%d .. %d", minValue, maxValue), (int)bounds.x, (int)(bounds.y + bounds.height + 8), 18, DARKGRAY);
+    DrawText(TextFormat("%d elements, %.1f per column; uploaded %d columns in %d calls",
+        (int)count, count > 0 ? (float)count / width : 0.0f, uploadedColumns, uploadCalls),
+        (int)bounds.x + 200, (int)(bounds.y + bounds.height + 8), 18, DARKGRAY);
+}
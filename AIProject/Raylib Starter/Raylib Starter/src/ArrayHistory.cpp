@@ -0,0 +1,135 @@
+#include "ArrayHistory.h"
+#include <algorithm>
+#include <cstring>
+
+void ArrayHistory::ChunkDeleter::operator()(Chunk* chunk) const {
+    (*stored)--;
+    delete chunk;
+}
+
+ArrayHistory::ChunkPtr ArrayHistory::NewChunk(const Chunk* copyOf) {
+    Chunk* chunk = new Chunk;
+    if (copyOf) memcpy(chunk, copyOf, sizeof(Chunk));
+    else memset(chunk, 0, sizeof(Chunk));
+    storedChunks++;
+    return ChunkPtr(chunk, ChunkDeleter{ &storedChunks });
+}
+
+void ArrayHistory::Reset(const std::vector<int>& values, const std::vector<bool>& occupied) {
+    checkpoints.clear();
+    live.clear();
+    writes.clear();
+    writes.shrink_to_fit();
+    stepEnds.clear();
+    stepEnds.shrink_to_fit();
+    firstStep = cursor = 0;
+    interval = 4096;
+
+    size = values.size();
+    live.resize((size + chunkSize - 1) / chunkSize);
+    for (size_t i = 0; i < size; i++)
+        if (occupied[i]) SetLive(i, { true, values[i] });
+    TakeCheckpoint();
+}
+
+size_t ArrayHistory::FootprintBytes() const {
+    return storedChunks * sizeof(Chunk) + writes.capacity() * sizeof(Write) + stepEnds.capacity() * sizeof(size_t)
+        + (checkpoints.size() + 1) * live.size() * sizeof(ChunkPtr);
+}
+
+// -----------------------------------------------------------------------------
+// Recording
+// -----------------------------------------------------------------------------
+ArrayHistory::Slot ArrayHistory::SlotIn(const Chunk* chunk, size_t k) {
+    if (!chunk || !((chunk->occupied[k / 64] >> (k % 64)) & 1)) return { false, 0 };
+    return { true, chunk->values[k] };
+}
+
+void ArrayHistory::SetLive(size_t index, Slot slot) {
+    if (index >= size) {
+        size = index + 1;
+        live.resize((size + chunkSize - 1) / chunkSize);
+    }
+    ChunkPtr& chunk = live[index / chunkSize];
+    if (!chunk && !slot.occupied) return; // already empty
+    if (!chunk) chunk = NewChunk(nullptr);
+    else if (chunk.use_count() > 1) chunk = NewChunk(chunk.get()); // a checkpoint still shares it
+
+    size_t k = index % chunkSize;
+    uint64_t bit = (uint64_t)1 << (k % 64);
+    if (slot.occupied) chunk->occupied[k / 64] |= bit;
+    else chunk->occupied[k / 64] &= ~bit;
+    chunk->values[k] = slot.occupied ? slot.value : 0;
+}
+
+void ArrayHistory::Record(size_t index, Slot before, Slot after) {
+    if (!AtNewest()) DropNewer();
+    writes.push_back({ (uint32_t)index, before.occupied ? before.value : 0, after.occupied ? after.value : 0,
+        before.occupied, after.occupied });
+    SetLive(index, after);
+}
+
+void ArrayHistory::EndStep() {
+    size_t open = stepEnds.empty() ? 0 : stepEnds.back();
+    if (writes.size() == open) return; // nothing written (a compare)
+    stepEnds.push_back(writes.size());
+    cursor++;
+
+    if (cursor - checkpoints.back().step >= interval) TakeCheckpoint();
+    if (writes.size() > maxWrites) TrimLog();
+}
+
+void ArrayHistory::DropNewer() {
+    writes.resize(WriteOffset(cursor));
+    stepEnds.resize(cursor - firstStep);
+    while (checkpoints.back().step > cursor) checkpoints.pop_back();
+}
+
+// -----------------------------------------------------------------------------
+// Checkpoints
+// -----------------------------------------------------------------------------
+void ArrayHistory::TakeCheckpoint() {
+    checkpoints.push_back({ cursor, live });
+    if (storedChunks > memoryFactor * live.size()) Thin();
+}
+
+void ArrayHistory::Thin() {
+    // Keep the first (the oldest step can always be reached) and every other
+    while (storedChunks > memoryFactor * live.size() && checkpoints.size() > 1) {
+        size_t kept = 1;
+        for (size_t i = 2; i < checkpoints.size(); i += 2) checkpoints[kept++] = std::move(checkpoints[i]);
+        checkpoints.resize(kept);
+        interval *= 2;
+    }
+}
+
+void ArrayHistory::TrimLog() {
+    // The second checkpoint becomes the oldest step. Without one (the memory
+    // budget thinned them all away) the history restarts from here.
+    if (checkpoints.size() < 2) checkpoints.push_back({ cursor, live });
+    size_t newFirst = checkpoints[1].step;
+    size_t dropped = WriteOffset(newFirst);
+    writes.erase(writes.begin(), writes.begin() + dropped);
+    stepEnds.erase(stepEnds.begin(), stepEnds.begin() + (newFirst - firstStep));
+    for (size_t& end : stepEnds) end -= dropped;
+    checkpoints.erase(checkpoints.begin());
+    firstStep = newFirst;
+}
+
+size_t ArrayHistory::WritesBetween(size_t a, size_t b) const {
+    size_t x = WriteOffset(a), y = WriteOffset(b);
+    return x > y ? x - y : y - x;
+}
+
+const ArrayHistory::Checkpoint& ArrayHistory::CheckpointBefore(size_t step) const {
+    auto after = std::upper_bound(checkpoints.begin(), checkpoints.end(), step,
+        [](size_t s, const Checkpoint& c) { return s < c.step; });
+    return *(after - 1);
+}
+
+size_t ArrayHistory::ChunksDiffering(const Checkpoint& checkpoint) const {
+    size_t differing = 0;
+    for (size_t c = 0; c < live.size(); c++)
+        if (c >= checkpoint.chunks.size() || live[c] != checkpoint.chunks[c]) differing++;
+    return differing;
+}
@@ -1,7 +1,13 @@
 #include "ArrayVisualizer.h"
+#include "FrameClock.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
+#include <random>
 
-ArrayVisualizer::ArrayVisualizer(int w, int h) : screenWidth(w), screenHeight(h) {
+ArrayVisualizer::ArrayVisualizer(int w, int h)
+    : screenWidth(w), screenHeight(h), chart({ 50, h / 2.0f - 40, w - 100.0f, 300 }) {
     inputBox = { 50, 170, 200, 40 };
     addButton = { 270, 170, 120, 40 };
     sizeBox = { 50, 100, 200, 40 };
@@ -10,10 +16,27 @@ ArrayVisualizer::ArrayVisualizer(int w, int h) : screenWidth(w), screenHeight(h)
 
     indexBox = { 50, 240, 200, 40 };
     setAtIndexButton = { 270, 240, 150, 40 };
+
+    searchModeButton = { 580, 100, 180, 40 };
+    findButton = { 410, 170, 120, 40 };
+    measureButton = { 440, 240, 200, 40 };
+
+    algorithmButton = { 780, 100, 200, 40 };
+    sortButton = { 1000, 100, 100, 40 };
+
+    growthButton = { 1120, 100, 200, 40 };
+
+    viewButton = { 1340, 100, 200, 40 };
+    fillButton = { 1340, 170, 200, 40 };
+
+    stepBackButton = { 1140, 240, 90, 40 };
+    stepForwardButton = { 1240, 240, 90, 40 };
+    timeline = { 50, h - 90.0f, w - 100.0f, 12 };
 }
 
 
 void ArrayVisualizer::HandleInput() {
+    ProfileScope scope(PHASE_INPUT);
     Vector2 mousePos = GetMousePosition();
 
     // Handle activation of input boxes
@@ -55,55 +78,89 @@ void ArrayVisualizer::HandleInput() {
         else if (activeIndexInput && !indexInput.empty()) indexInput.pop_back();
     }
 
+    // Scroll the window of visible slots: the wheel moves four, the arrow
+    // keys one, Home/End jump to either end
+    long long scroll = (long long)(-GetMouseWheelMove() * 4);
+    if (IsKeyPressed(KEY_RIGHT) || IsKeyPressedRepeat(KEY_RIGHT)) scroll++;
+    if (IsKeyPressed(KEY_LEFT) || IsKeyPressedRepeat(KEY_LEFT)) scroll--;
+    size_t slots = std::max((size_t)std::max(maxSize, 0), elements.Size());
+    size_t lastFirst = slots > VisibleSlots() ? slots - VisibleSlots() : 0;
+    if (scroll < 0) firstSlot -= std::min(firstSlot, (size_t)-scroll);
+    else firstSlot = std::min(firstSlot + (size_t)scroll, lastFirst);
+    if (IsKeyPressed(KEY_HOME)) firstSlot = 0;
+    if (IsKeyPressed(KEY_END)) firstSlot = lastFirst;
+
+    // Growth policy; leaving vector mode keeps the current capacity as the fixed size
+    if (CheckCollisionPointRec(mousePos, growthButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && !reallocating) {
+        growthPolicy = (GrowthPolicy)((growthPolicy + 1) % GROWTH_COUNT);
+        ResetGrowthStats();
+    }
+
+    // Vector mode: Set Size reserves, growing (and copying) only when larger
+    if (growthPolicy != GROWTH_FIXED && CheckCollisionPointRec(mousePos, setSizeButton)
+        && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        if (!sizeInput.empty() && !reallocating) {
+            int capacity = std::stoi(sizeInput);
+            if (capacity > maxSize) StartReallocation(capacity);
+            sizeInput.clear();
+        }
+    }
+
     // Set array size
-    if (CheckCollisionPointRec(mousePos, setSizeButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+    else if (CheckCollisionPointRec(mousePos, setSizeButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
         if (!sizeInput.empty()) {
             maxSize = std::stoi(sizeInput);
-            elements.clear();
+            ClearElements();
+            firstSlot = 0;
+            worker.Cancel();
+            sortReplaying = false;
             sizeInput.clear();
         }
     }
 
     // Add element sequentially (append)
     if (CheckCollisionPointRec(mousePos, addButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-        if (!inputValue.empty() && elements.size() < maxSize) {
+        if (!inputValue.empty() && !reallocating) {
             int val = std::stoi(inputValue);
-            float spacing = 80.0f;
-            float startX = 50.0f;
-            float startY = screenHeight / 2.0f;
-            elements.push_back(AnimatedElement(val, startX + elements.size() * spacing, -50, startY));
-            inputValue.clear();
+            if (elements.Size() < (size_t)maxSize) {
+                PushElement(val);
+                inputValue.clear();
+            }
+            else if (growthPolicy != GROWTH_FIXED) {
+                // Full: grow first, the push lands once the copy is done
+                pendingValue = val;
+                pushPending = true;
+                StartReallocation((int)GrowCapacity(growthPolicy, maxSize));
+                inputValue.clear();
+            }
         }
     }
 
     // Set element at specific index
     // Set element at specific index
     if (CheckCollisionPointRec(mousePos, setAtIndexButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-        if (!inputValue.empty() && !indexInput.empty() && maxSize > 0) {
+        if (!inputValue.empty() && !indexInput.empty() && maxSize > 0 && !reallocating) {
             int val = std::stoi(inputValue);
             int index = std::stoi(indexInput);
 
             if (index >= 0 && index < maxSize) {
-                float spacing = 80.0f;
-                float startX = 50.0f;
                 float startY = screenHeight / 2.0f;
 
-                if (index < (int)elements.size()) {
+                if (AnimatedElement* e = elements.Find(index)) {
                     // Replace existing value
-                    elements[index].value = val;
-                    elements[index].highlightTimer = 0.5f; // 0.5 seconds of highlight
-                    elements[index].y = startY - 15; // small animation bump
+                    NoteWrite(index, e, val);
+                    e->value = val;
+                    Flash(*e, 0.5f);
+                    e->y = startY - 15; // small animation bump
+                    tweens.Add(&e->y, startY, 0.3f);
                 }
                 else {
-                    // Add empty placeholders until we reach index
-                    while ((int)elements.size() < index)
-                        elements.push_back(AnimatedElement(0, startX + elements.size() * spacing, startY, startY));
-
-                    // Add new element
-                    AnimatedElement newElem(val, startX + index * spacing, -50, startY);
-                    newElem.highlightTimer = 0.5f; // flash when added
-                    elements.push_back(newElem);
+                    // New element, flashing as it drops in; the slots before
+                    // it stay empty rather than holding placeholders
+                    Flash(PlaceElement(index, val, -50), 0.5f);
                 }
+                history.EndStep();
+                ScrollTo(index);
 
                 inputValue.clear();
                 indexInput.clear();
@@ -112,10 +169,90 @@ void ArrayVisualizer::HandleInput() {
     }
 
 
+    // Boxes -> bars -> heatmap; the chart missed every write made while hidden
+    if (CheckCollisionPointRec(mousePos, viewButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        view = (ArrayView)((view + 1) % VIEW_COUNT);
+        if (view != VIEW_BOXES) chart.SetMode(view == VIEW_HEATMAP ? CHART_HEATMAP : CHART_BARS);
+        chartStale = true;
+    }
+    if (CheckCollisionPointRec(mousePos, fillButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && !reallocating) {
+        FillRandom();
+    }
+
+    // Step back/forward (also Ctrl+Z / Ctrl+Y) and dragging along the timeline;
+    // not while a growth animation is moving the elements
+    bool ctrl = IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL);
+    if (!reallocating && !historyStale && !historyOff) {
+        if ((CheckCollisionPointRec(mousePos, stepBackButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
+            || (ctrl && IsKeyPressed(KEY_Z))) {
+            if (history.Cursor() > history.FirstStep()) SeekHistory(history.Cursor() - 1);
+        }
+        if ((CheckCollisionPointRec(mousePos, stepForwardButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
+            || (ctrl && IsKeyPressed(KEY_Y))) {
+            SeekHistory(history.Cursor() + 1);
+        }
+        Rectangle timelineHit = { timeline.x - 10, timeline.y - 10, timeline.width + 20, timeline.height + 20 };
+        if (CheckCollisionPointRec(mousePos, timelineHit) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) scrubbing = true;
+        if (scrubbing && history.NewestStep() > history.FirstStep()) {
+            float t = std::clamp((mousePos.x - timeline.x) / timeline.width, 0.0f, 1.0f);
+            size_t span = history.NewestStep() - history.FirstStep();
+            SeekHistory(history.FirstStep() + (size_t)(t * span + 0.5f));
+        }
+    }
+    if (!IsMouseButtonDown(MOUSE_LEFT_BUTTON)) scrubbing = false;
+
+    // Pick the sort algorithm / start sorting
+    if (CheckCollisionPointRec(mousePos, algorithmButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        sortAlgorithm = (SortAlgorithm)((sortAlgorithm + 1) % SORT_COUNT);
+    }
+    if (CheckCollisionPointRec(mousePos, sortButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        if (!searchMode) StartSort();
+    }
+
+    // Toggle sorted array search mode
+    if (CheckCollisionPointRec(mousePos, searchModeButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        searchMode = !searchMode;
+        if (searchMode) BuildSearchLayouts();
+    }
+
+    if (searchMode) {
+        // Find: animate the probes of each layout
+        if (CheckCollisionPointRec(mousePos, findButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+            if (!inputValue.empty()) {
+                BuildSearchLayouts();
+                StartLayoutSearch(std::stoi(inputValue));
+                inputValue.clear();
+            }
+        }
+
+        // Batch lookups: time every layout and kernel
+        if (CheckCollisionPointRec(mousePos, measureButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+            BuildSearchLayouts();
+            MeasureLayouts();
+        }
+    }
+
+    // Cache view: search for the typed value (default the last element),
+    // insert at the typed index (default the front, the longest shift)
+    cacheView.HandleInput();
+    int cacheKey = 0;
+    if (cacheView.Op() == CACHE_TRACE_SEARCH)
+        cacheKey = !inputValue.empty() ? atoi(inputValue.c_str()) : elements.Size() == 0 ? 0 : ValueAt(elements.Size() - 1);
+    else if (cacheView.Op() == CACHE_TRACE_INSERT)
+        cacheKey = !indexInput.empty() ? atoi(indexInput.c_str()) : 0;
+    if (cacheView.NeedsReplay(cacheKey, elements.OccupiedCount())) {
+        TraceOperation(cacheView.Op(), cacheKey, cacheView.BeginTrace());
+        cacheView.Replay();
+    }
+
     // Clear array
     if (CheckCollisionPointRec(mousePos, clearButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-        elements.clear();
+        ClearElements();
+        worker.Cancel();
+        sortReplaying = false;
         maxSize = 0;
+        firstSlot = 0;
+        ResetGrowthStats();
         inputValue.clear();
         sizeInput.clear();
         indexInput.clear();
@@ -127,29 +264,474 @@ void ArrayVisualizer::HandleInput() {
 
 
 void ArrayVisualizer::UpdateAnimations() {
-    const float speed = 5.0f;
-    for (auto& e : elements) {
-        // Smooth drop animation
-        if (e.y < e.targetY) {
-            e.y += speed;
-            if (e.y > e.targetY) e.y = e.targetY;
+    ProfileScope scope(PHASE_ANIMATION_TICK);
+    float dt = FrameTime();
+    tweens.Tick(dt);
+
+    // A sort replay waits while an older step is shown
+    if (historyStale) ResetHistory();
+    if (sortReplaying && history.AtNewest()) ReplaySortEvents(dt);
+    if (reallocating) UpdateReallocation(dt);
+
+    // Redraw the chart columns this frame's writes touched
+    if (view != VIEW_BOXES) {
+        size_t slots = std::max((size_t)std::max(maxSize, 0), elements.Size());
+        if (chartStale || chart.Count() != slots) RebuildChart();
+        chart.Update();
+    }
+
+    // Advance the probe animation of every layout together
+    if (searchAnimating) {
+        searchTimer += dt;
+        if (searchTimer >= searchDelay) {
+            searchTimer = 0.0f;
+            searchStep++;
+
+            size_t longest = 0;
+            for (int l = 0; l < LAYOUT_COUNT; l++)
+                longest = std::max(longest, searchProbes[l].size());
+            if (searchStep >= (int)longest) searchAnimating = false;
         }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Element storage. The tween engine holds pointers into the slots, so clearing
+// drops the tweens first.
+// -----------------------------------------------------------------------------
+AnimatedElement& ArrayVisualizer::PlaceElement(size_t index, int value, float y) {
+    float startY = screenHeight / 2.0f;
+    NoteWrite(index, elements.Find(index), value);
+    AnimatedElement& e = elements.Set(index, AnimatedElement(value, y));
+    if (y != startY) tweens.Add(&e.y, startY, 0.8f);
+    return e;
+}
+
+int ArrayVisualizer::ValueAt(size_t index) const {
+    const AnimatedElement* e = elements.Find(index);
+    return e ? e->value : 0;
+}
+
+void ArrayVisualizer::ClearElements() {
+    // A sort still replaying would write into slots that are gone
+    worker.Cancel();
+    sortReplaying = false;
+    tweens.Clear();
+    elements.Clear();
+    chartStale = true;
+    historyStale = true;
+}
+
+size_t ArrayVisualizer::VisibleSlots() const {
+    return (size_t)((screenWidth - 50.0f) / 80.0f) + 1; // startX, spacing
+}
+
+void ArrayVisualizer::ScrollTo(size_t index) {
+    // Only scroll when the slot is off screen, and then put it in the middle
+    size_t visible = VisibleSlots();
+    if (index >= firstSlot && index + 1 < firstSlot + visible) return;
+    firstSlot = index > visible / 2 ? index - visible / 2 : 0;
+}
+
+void ArrayVisualizer::Flash(AnimatedElement& e, float seconds) {
+    e.highlight = 1.0f;
+    tweens.Add(&e.highlight, 0.0f, seconds, EASE_LINEAR);
+}
+
+// -----------------------------------------------------------------------------
+// Chart views. Empty slots count as zeros.
+// -----------------------------------------------------------------------------
+void ArrayVisualizer::NoteWrite(size_t index, const AnimatedElement* old, int newValue) {
+    int oldValue = old ? old->value : 0;
+    if (view != VIEW_BOXES && !chartStale) chart.Write(index, oldValue, newValue);
+    if (historyStale || historyOff || (old && oldValue == newValue)) return;
+    if (index >= historySlots) {
+        historyOff = true;
+        return;
+    }
+
+    // An edit behind the newest step starts a new branch; a paused sort
+    // can't carry on from there
+    if (!history.AtNewest()) {
+        worker.Cancel();
+        sortReplaying = false;
+    }
+    history.Record(index, { old != nullptr, oldValue }, { true, newValue });
+}
+
+void ArrayVisualizer::RebuildChart() {
+    chart.Reset(std::max((size_t)std::max(maxSize, 0), elements.Size()));
+    for (size_t i = elements.NextOccupied(0); i < elements.Size(); i = elements.NextOccupied(i + 1))
+        chart.Add(i, elements.Find(i)->value);
+    chartStale = false;
+}
+
+void ArrayVisualizer::FillRandom() {
+    // Every slot of the current size, up to 1M; without a size, 1M slots
+    const size_t limit = 1 << 20;
+    size_t count = maxSize > 0 ? std::min((size_t)maxSize, limit) : limit;
+    std::mt19937 rng(std::random_device{}());
+    std::uniform_int_distribution<int> dist(0, 999);
+    std::vector<int> values(count);
+    for (int& v : values) v = dist(rng);
+    SetValues(values);
+    ResetGrowthStats();
+    if (view == VIEW_BOXES && count > VisibleSlots()) {
+        view = VIEW_BARS;
+        chart.SetMode(CHART_BARS);
+    }
+}
 
-        // Decrease highlight timer
-        if (e.highlightTimer > 0.0f)
-            e.highlightTimer -= GetFrameTime();
+// -----------------------------------------------------------------------------
+// History. Seeking writes the values straight into the slots, so nothing is
+// recorded again; a slot that was empty at the step sought is erased, so undoing
+// a push or a first write takes the element away. A single step flashes what it
+// changed.
+// -----------------------------------------------------------------------------
+void ArrayVisualizer::ResetHistory() {
+    // Only up to the last written slot; later ones grow it as they're written
+    historyStale = false;
+    historyOff = elements.Size() > historySlots;
+    std::vector<int> values(historyOff ? 0 : elements.Size(), 0);
+    std::vector<bool> occupied(values.size(), false);
+    for (size_t i = elements.NextOccupied(0); i < values.size(); i = elements.NextOccupied(i + 1)) {
+        values[i] = elements.Find(i)->value;
+        occupied[i] = true;
     }
+    history.Reset(values, occupied);
+}
+
+void ArrayVisualizer::SeekHistory(size_t step) {
+    size_t cursor = history.Cursor();
+    bool flash = view == VIEW_BOXES && (step == cursor + 1 || step + 1 == cursor);
+    float startY = screenHeight / 2.0f;
+    size_t last = SIZE_MAX;
+    history.Seek(step, [&](size_t index, ArrayHistory::Slot slot) {
+        AnimatedElement* e = elements.Find(index);
+        if (view != VIEW_BOXES && !chartStale) chart.Write(index, e ? e->value : 0, slot.value);
+        last = index;
+        if (!slot.occupied) {
+            // The tween engine holds pointers into the slot
+            if (e) tweens.CancelRange(e, sizeof(AnimatedElement));
+            elements.Erase(index);
+            return;
+        }
+        if (e) e->value = slot.value;
+        else e = &elements.Set(index, AnimatedElement(slot.value, startY));
+        if (flash) Flash(*e, 0.3f);
+    });
+    if (flash && last != SIZE_MAX) ScrollTo(last);
+}
+
+// -----------------------------------------------------------------------------
+// Vector mode
+// -----------------------------------------------------------------------------
+void ArrayVisualizer::PushElement(int value) {
+    size_t index = elements.Size();
+    PlaceElement(index, value, -50);
+    history.EndStep();
+    ScrollTo(index);
+    pushes++;
+}
+
+void ArrayVisualizer::StartReallocation(int capacity) {
+    // Both blocks are live until the copy is done
+    reallocations++;
+    elementsCopied += elements.Size();
+    peakBytes = std::max(peakBytes, (size_t)(maxSize + capacity) * sizeof(int));
+
+    // The copy animation moves the elements itself
+    for (size_t i = elements.NextOccupied(0); i < elements.Size(); i = elements.NextOccupied(i + 1))
+        tweens.Cancel(&elements.Find(i)->y);
+
+    newCapacity = capacity;
+    reallocCopied = 0.0f;
+    reallocSlide = 0.0f;
+    reallocating = true;
+}
+
+void ArrayVisualizer::UpdateReallocation(float dt) {
+    const float blockDrop = 130.0f; // the new block is drawn below the old one
+    float startY = screenHeight / 2.0f;
+
+    // Copy about 8 elements a second, but never take more than 2 seconds
+    size_t count = elements.Size();
+    if (reallocCopied < count) {
+        reallocCopied += dt * std::max(8.0f, count / 2.0f);
+        for (size_t i = elements.NextOccupied(0); i < count; i = elements.NextOccupied(i + 1)) {
+            float t = std::min(1.0f, std::max(0.0f, reallocCopied - i)); // element i moves during [i, i + 1)
+            elements.Find(i)->y = startY + blockDrop * t;
+        }
+        return;
+    }
+
+    // Old block freed: slide the new one into its place
+    reallocSlide = std::min(1.0f, reallocSlide + dt * 3.0f);
+    for (size_t i = elements.NextOccupied(0); i < count; i = elements.NextOccupied(i + 1))
+        elements.Find(i)->y = startY + blockDrop * (1.0f - reallocSlide);
+    if (reallocSlide < 1.0f) return;
+
+    maxSize = newCapacity;
+    reallocating = false;
+    if (pushPending) {
+        pushPending = false;
+        PushElement(pendingValue);
+    }
+}
+
+void ArrayVisualizer::ResetGrowthStats() {
+    pushes = reallocations = elementsCopied = 0;
+    peakBytes = (size_t)maxSize * sizeof(int);
+    reallocating = false;
+    pushPending = false;
+    float startY = screenHeight / 2.0f;
+    for (size_t i = elements.NextOccupied(0); i < elements.Size(); i = elements.NextOccupied(i + 1)) {
+        AnimatedElement* e = elements.Find(i);
+        e->y = std::min(e->y, startY);
+    }
+}
+
+// Roughly how many steps sorting n elements makes. A streamed trace has no
+// length until it ends, so the replay is paced from this.
+static uint64_t SortEventEstimate(SortAlgorithm algorithm, size_t n) {
+    if (n < 2) return 0;
+    switch (algorithm) {
+    case SORT_INSERTION: return (uint64_t)n * n / 2; // compares + writes on random input
+    case SORT_RADIX: return (uint64_t)n * 4;         // a write per element per pass
+    default: return (uint64_t)(2.0 * n * std::log2((double)n));
+    }
+}
+
+bool ArrayVisualizer::SortAllowed() const {
+    // Steps carry 32-bit indices
+    size_t count = elements.OccupiedCount();
+    if (count > (size_t)INT32_MAX) return false;
+    return sortAlgorithm != SORT_INSERTION || count <= quadraticSortLimit;
+}
+
+void ArrayVisualizer::StartSort() {
+    if (elements.OccupiedCount() < 2 || !SortAllowed()) return;
+
+    // The worker sorts a copy, publishing each step as the algorithm makes
+    // it; the elements catch up during replay. Only written slots take part:
+    // the sorted values go back into the same slots, so empty ones stay empty
+    // and a sparse array stays sparse. Step k's indices are into sortSlots.
+    std::vector<int> values;
+    values.reserve(elements.OccupiedCount());
+    sortSlots.clear();
+    sortSlots.reserve(elements.OccupiedCount());
+    for (size_t i = elements.NextOccupied(0); i < elements.Size(); i = elements.NextOccupied(i + 1)) {
+        sortSlots.push_back(i);
+        values.push_back(elements.Find(i)->value);
+    }
+
+    // Sorting what's shown: the steps after it go, as with any edit. New
+    // values haven't been given a history until the next frame, so start it.
+    if (historyStale) ResetHistory();
+    history.DropNewer();
+
+    SortAlgorithm algorithm = sortAlgorithm;
+    sortEventCount = SortEventEstimate(algorithm, values.size());
+    worker.Run([values = std::move(values), algorithm](ModelWorker& w) mutable {
+        // Publish waits while the ring is full and fails once cancelled,
+        // which stops the sort
+        SortStreamed(algorithm, values.data(), values.size(), [&w](const SortEvent& ev) {
+            VisEvent e = { VIS_VALUE_SET, (int32_t)ev.index, ev.other, 0 };
+            if (ev.op == SORT_OP_COMPARE) e.type = VIS_HIGHLIGHT;
+            else if (ev.op == SORT_OP_SWAP) e.type = VIS_VALUES_SWAPPED;
+            return w.Publish(e);
+        });
+    });
+
+    sortCursor = 0;
+    sortCompares = sortSwaps = sortWrites = 0;
+    sortBudget = 0.0f;
+    sortReplaying = true;
+}
+
+void ArrayVisualizer::ReplaySortEvents(float dt) {
+    ProfileScope scope(PHASE_MODEL_UPDATE);
+    // Pace the replay so any trace takes roughly eight seconds, but never
+    // slower than a few steps per second
+    float eventsPerSecond = std::max(4.0f, sortEventCount / 8.0f);
+    sortBudget += eventsPerSecond * dt;
+
+    size_t owed = (size_t)sortBudget;
+    size_t applied = worker.Drain(owed, [this](const VisEvent& e) { ApplySortEvent(e); });
+    sortBudget -= applied;
+    if (applied < owed) sortBudget -= (float)(size_t)sortBudget; // don't bank time while the worker is still sorting
+
+    if (!worker.Busy()) {
+        sortReplaying = false;
+        sortEventCount = sortCursor; // the estimate gives way to the real count
+        sortSlots.clear();
+        sortSlots.shrink_to_fit();
+    }
+}
+
+void ArrayVisualizer::ApplySortEvent(const VisEvent& e) {
+    sortCursor++;
+    if (e.type == VIS_HIGHLIGHT) sortCompares++;
+    else if (e.type == VIS_VALUES_SWAPPED) sortSwaps++;
+    else sortWrites++;
+    if ((size_t)e.a >= sortSlots.size()) return;
+    size_t slotA = sortSlots[e.a];
+    size_t slotB = e.type != VIS_VALUE_SET && (size_t)e.b < sortSlots.size() ? sortSlots[e.b] : SIZE_MAX;
+
+    // The chart shows values only: compares change nothing and writes skip
+    // the flash, so a replay costs one chart write per changed slot
+    bool charted = view != VIEW_BOXES;
+
+    // Every sorted slot was written when the sort began, and clearing stops it
+    if (e.type == VIS_HIGHLIGHT) {
+        if (charted) return;
+        for (size_t index : { slotA, slotB }) {
+            AnimatedElement* compared = elements.Find(index);
+            if (!compared) continue;
+            compared->compare = 1.0f;
+            tweens.Add(&compared->compare, 0.0f, 0.2f, EASE_LINEAR);
+        }
+    }
+    else if (e.type == VIS_VALUES_SWAPPED) {
+        AnimatedElement* a = elements.Find(slotA);
+        AnimatedElement* b = slotB != SIZE_MAX ? elements.Find(slotB) : nullptr;
+        if (!a || !b) return;
+        int valueA = a->value, valueB = b->value;
+        NoteWrite(slotA, a, valueB);
+        NoteWrite(slotB, b, valueA);
+        a->value = valueB;
+        b->value = valueA;
+        history.EndStep();
+        if (charted) return;
+        Flash(*a, 0.3f);
+        Flash(*b, 0.3f);
+    }
+    else if (e.type == VIS_VALUE_SET) {
+        AnimatedElement* a = elements.Find(slotA);
+        if (!a) return;
+        NoteWrite(slotA, a, e.b);
+        a->value = e.b;
+        history.EndStep();
+        if (!charted) Flash(*a, 0.3f);
+    }
+}
+
+void ArrayVisualizer::BuildSearchLayouts() {
+    std::vector<int> keys;
+    keys.reserve(elements.OccupiedCount());
+    for (size_t i = elements.NextOccupied(0); i < elements.Size(); i = elements.NextOccupied(i + 1))
+        keys.push_back(elements.Find(i)->value);
+    searchEngine.Build(keys);
+    searchAnimating = false;
+}
+
+void ArrayVisualizer::StartLayoutSearch(int value) {
+    searchValue = value;
+    for (int l = 0; l < LAYOUT_COUNT; l++) {
+        searchEngine.Trace(value, (SearchLayout)l, searchProbes[l]);
+        searchResult[l] = searchEngine.Find(value, (SearchLayout)l, KERNEL_SIMD);
+    }
+    searchStep = 0;
+    searchTimer = 0.0f;
+    searchAnimating = true;
+}
+
+void ArrayVisualizer::SortWith(SortAlgorithm algorithm) {
+    sortAlgorithm = algorithm;
+    StartSort();
+    worker.WaitForOutput(); // the replay must not depend on the worker's speed
+}
+
+void ArrayVisualizer::SetValues(const std::vector<int>& values) {
+    maxSize = (int)values.size();
+    ClearElements();
+    firstSlot = 0;
+    for (size_t i = 0; i < values.size(); i++)
+        elements.Set(i, AnimatedElement(values[i], screenHeight / 2.0f));
+}
+
+ArrayVisualizer::Snapshot ArrayVisualizer::TakeSnapshot() const {
+    Snapshot snapshot;
+    snapshot.maxSize = reallocating ? newCapacity : maxSize;
+    snapshot.slots.reserve(elements.OccupiedCount());
+    snapshot.values.reserve(elements.OccupiedCount());
+    for (size_t i = elements.NextOccupied(0); i < elements.Size(); i = elements.NextOccupied(i + 1)) {
+        snapshot.slots.push_back(i);
+        snapshot.values.push_back(elements.Find(i)->value);
+    }
+    if (reallocating && pushPending) {
+        // Growing finishes at once, push included
+        snapshot.slots.push_back(elements.Size());
+        snapshot.values.push_back(pendingValue);
+    }
+    snapshot.view = view;
+    snapshot.sortAlgorithm = sortAlgorithm;
+    snapshot.growthPolicy = growthPolicy;
+    return snapshot;
+}
+
+void ArrayVisualizer::Restore(const Snapshot& snapshot) {
+    ClearElements();
+    maxSize = snapshot.maxSize;
+    for (size_t k = 0; k < snapshot.slots.size(); k++)
+        elements.Set(snapshot.slots[k], AnimatedElement(snapshot.values[k], screenHeight / 2.0f));
+    ResetGrowthStats();
+    view = snapshot.view;
+    if (view != VIEW_BOXES) chart.SetMode(view == VIEW_HEATMAP ? CHART_HEATMAP : CHART_BARS);
+    sortAlgorithm = snapshot.sortAlgorithm;
+    growthPolicy = snapshot.growthPolicy;
+}
+
+void ArrayVisualizer::TraceOperation(CacheTraceOp op, int key, AddressTrace& trace) const {
+    // Only written slots are in memory; empty ones cost no accesses
+    if (op == CACHE_TRACE_INSERT) {
+        // Shifting moves whole elements, back to front
+        std::vector<size_t> moved;
+        for (size_t i = elements.NextOccupied(std::max(key, 0)); i < elements.Size(); i = elements.NextOccupied(i + 1))
+            moved.push_back(i);
+        for (size_t k = moved.size(); k-- > 0;) {
+            size_t i = moved[k];
+            RecordAccess(trace, elements.Find(i), sizeof(AnimatedElement), (int)i);
+            if (const AnimatedElement* next = elements.Find(i + 1))
+                RecordAccess(trace, next, sizeof(AnimatedElement), (int)(i + 1));
+        }
+        return;
+    }
+
+    // Scans only read the values
+    for (size_t i = elements.NextOccupied(0); i < elements.Size(); i = elements.NextOccupied(i + 1)) {
+        const AnimatedElement* e = elements.Find(i);
+        RecordAccess(trace, &e->value, sizeof(int), (int)i);
+        if (op == CACHE_TRACE_SEARCH && e->value == key) break;
+    }
+}
+
+void ArrayVisualizer::MeasureLayouts() {
+    if (searchEngine.Size() == 0) return;
+
+    // Random queries spanning the key range, misses included
+    const int* sorted = searchEngine.Data(LAYOUT_SORTED);
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> dist(sorted[0] - 1, sorted[searchEngine.Size() - 1] + 1);
+    std::vector<int> queries(1 << 20);
+    for (int& q : queries) q = dist(rng);
+
+    for (int l = 0; l < LAYOUT_COUNT; l++)
+        for (int k = 0; k < KERNEL_COUNT; k++)
+            nsPerLookup[l][k] = searchEngine.MeasureNsPerLookup(queries, (SearchLayout)l, (SearchKernel)k);
+    lookupsMeasured = true;
 }
 
 
 void ArrayVisualizer::DrawUI() {
+    ProfileScope scope(PHASE_DRAW);
     // Array size
     DrawRectangleRec(sizeBox, activeSizeInput ? RAYWHITE : LIGHTGRAY);
     DrawRectangleLinesEx(sizeBox, 2, DARKGRAY);
     DrawText(sizeInput.c_str(), sizeBox.x + 5, sizeBox.y + 5, 20, BLACK);
     DrawRectangleRec(setSizeButton, LIGHTGRAY);
     DrawRectangleLinesEx(setSizeButton, 2, DARKGRAY);
-    DrawText("Set Size", setSizeButton.x + 10, setSizeButton.y + 5, 20, BLACK);
+    DrawText(growthPolicy != GROWTH_FIXED ? "Reserve" : "Set Size", setSizeButton.x + 10, setSizeButton.y + 5, 20, BLACK);
 
     // Clear button
     DrawRectangleRec(clearButton, LIGHTGRAY);
@@ -172,45 +754,220 @@ void ArrayVisualizer::DrawUI() {
     DrawRectangleLinesEx(setAtIndexButton, 2, DARKGRAY);
     DrawText("Set At Index", setAtIndexButton.x + 10, setAtIndexButton.y + 5, 20, BLACK);
 
+    // Sorting
+    DrawRectangleRec(algorithmButton, LIGHTGRAY);
+    DrawRectangleLinesEx(algorithmButton, 2, DARKGRAY);
+    DrawText(SortName(sortAlgorithm), algorithmButton.x + 10, algorithmButton.y + 5, 20, BLACK);
+    bool sortable = SortAllowed();
+    DrawRectangleRec(sortButton, sortReplaying ? SKYBLUE : LIGHTGRAY);
+    DrawRectangleLinesEx(sortButton, 2, DARKGRAY);
+    DrawText("Sort", sortButton.x + 28, sortButton.y + 5, 20, sortable ? BLACK : GRAY);
+    if (!sortable && !sortReplaying)
+        DrawText(TextFormat("%s sort: up to %d elements", SortName(sortAlgorithm), (int)quadraticSortLimit),
+            algorithmButton.x, algorithmButton.y + 75, 20, MAROON);
+
+    if (sortEventCount > 0)
+        DrawText(TextFormat("Step %llu / %s%llu   compares %llu  swaps %llu  writes %llu",
+            (unsigned long long)sortCursor, sortReplaying ? "~" : "", (unsigned long long)sortEventCount,
+            (unsigned long long)sortCompares, (unsigned long long)sortSwaps, (unsigned long long)sortWrites),
+            algorithmButton.x, algorithmButton.y + 50, 20, DARKGRAY);
+
+    // Search mode
+    DrawRectangleRec(searchModeButton, searchMode ? SKYBLUE : LIGHTGRAY);
+    DrawRectangleLinesEx(searchModeButton, 2, DARKGRAY);
+    DrawText(searchMode ? "Array Mode" : "Search Mode", searchModeButton.x + 10, searchModeButton.y + 5, 20, BLACK);
+
+    if (searchMode) {
+        DrawRectangleRec(findButton, LIGHTGRAY);
+        DrawRectangleLinesEx(findButton, 2, DARKGRAY);
+        DrawText("Find", findButton.x + 35, findButton.y + 5, 20, BLACK);
+
+        DrawRectangleRec(measureButton, LIGHTGRAY);
+        DrawRectangleLinesEx(measureButton, 2, DARKGRAY);
+        DrawText("Batch Lookups", measureButton.x + 10, measureButton.y + 5, 20, BLACK);
+    }
+
+    cacheView.Draw();
+
+    // Vector mode
+    DrawRectangleRec(growthButton, growthPolicy != GROWTH_FIXED ? SKYBLUE : LIGHTGRAY);
+    DrawRectangleLinesEx(growthButton, 2, DARKGRAY);
+    DrawText(TextFormat("Growth: %s", GrowthPolicyName(growthPolicy)), growthButton.x + 10, growthButton.y + 5, 20, BLACK);
+
+    // View
+    static const char* viewNames[VIEW_COUNT] = { "View: Boxes", "View: Bars", "View: Heatmap" };
+    DrawRectangleRec(viewButton, view != VIEW_BOXES ? SKYBLUE : LIGHTGRAY);
+    DrawRectangleLinesEx(viewButton, 2, DARKGRAY);
+    DrawText(viewNames[view], viewButton.x + 10, viewButton.y + 5, 20, BLACK);
+    DrawRectangleRec(fillButton, LIGHTGRAY);
+    DrawRectangleLinesEx(fillButton, 2, DARKGRAY);
+    DrawText("Fill Random", fillButton.x + 10, fillButton.y + 5, 20, BLACK);
+    if (growthPolicy != GROWTH_FIXED) {
+        // Cost per push in element writes: the push itself plus its share of the copies
+        float copiesPerPush = pushes ? (float)elementsCopied / pushes : 0.0f;
+        DrawText(TextFormat("pushes %d  reallocs %d  bytes copied %d  peak %d B  amortized %.2f writes/push",
+            (int)pushes, (int)reallocations, (int)(elementsCopied * sizeof(int)), (int)peakBytes, 1.0f + copiesPerPush),
+            growthButton.x - 420, growthButton.y + 80, 20, DARKGRAY);
+    }
+
+    DrawRectangleRec(stepBackButton, LIGHTGRAY);
+    DrawRectangleLinesEx(stepBackButton, 2, DARKGRAY);
+    DrawText("< Step", stepBackButton.x + 12, stepBackButton.y + 10, 20, BLACK);
+    DrawRectangleRec(stepForwardButton, LIGHTGRAY);
+    DrawRectangleLinesEx(stepForwardButton, 2, DARKGRAY);
+    DrawText("Step >", stepForwardButton.x + 12, stepForwardButton.y + 10, 20, BLACK);
+    if (historyOff)
+        DrawText(TextFormat("History off: slots past %d aren't recorded", (int)historySlots),
+            (int)timeline.x, (int)(timeline.y + timeline.height + 10), 20, DARKGRAY);
+    else
+        DrawTimeline();
+
     // Info
     if (maxSize > 0)
-        DrawText(TextFormat("Elements: %d / %d", (int)elements.size(), maxSize),
+        DrawText(TextFormat("Elements: %d / %d   pages: %d (%d KB)", (int)elements.OccupiedCount(), maxSize,
+            (int)elements.PageCount(), (int)(elements.FootprintBytes() / 1024)),
             inputBox.x, inputBox.y + 50, 20, DARKGRAY);
 }
 
 
+void ArrayVisualizer::DrawTimeline() {
+    size_t first = history.FirstStep(), newest = history.NewestStep(), cursor = history.Cursor();
+    float t = newest > first ? (float)(cursor - first) / (newest - first) : 0.0f;
+
+    DrawRectangleRec(timeline, Fade(LIGHTGRAY, 0.6f));
+    DrawRectangleLinesEx(timeline, 1, GRAY);
+    DrawRectangle((int)timeline.x, (int)timeline.y, (int)(timeline.width * t), (int)timeline.height, Fade(SKYBLUE, 0.8f));
+    DrawCircleV({ timeline.x + timeline.width * t, timeline.y + timeline.height / 2 }, 9, DARKBLUE);
+
+    // Chunks stored by the checkpoints and the array itself, against one copy
+    size_t arrayChunks = std::max(history.ArrayChunks(), (size_t)1);
+    DrawText(TextFormat("Step %d / %d%s   |   %d checkpoints, %.1fx the array, %d KB in all",
+        (int)cursor, (int)newest, sortReplaying && !history.AtNewest() ? " (sort paused)" : "",
+        (int)history.CheckpointCount(), (float)history.StoredChunks() / arrayChunks,
+        (int)(history.FootprintBytes() / 1024)),
+        (int)timeline.x, (int)(timeline.y + timeline.height + 10), 20, DARKGRAY);
+}
+
+void ArrayVisualizer::DrawSearchLayouts() {
+    const float startX = 50.0f;
+    const float boxHeight = 40.0f;
+    const float rowSpacing = 150.0f;
+    float firstRowY = screenHeight / 2.0f - 60.0f;
+
+    for (int l = 0; l < LAYOUT_COUNT; l++) {
+        SearchLayout layout = (SearchLayout)l;
+        const int* data = searchEngine.Data(layout);
+        int cells = searchEngine.Cells(layout);
+        float y = firstRowY + l * rowSpacing;
+
+        // Shrink cells to fit the screen; past ~2px per cell only the first cells are shown
+        float cellWidth = cells > 0 ? std::min(60.0f, (screenWidth - 2 * startX) / cells) : 60.0f;
+        cellWidth = std::max(cellWidth, 2.0f);
+        int visible = std::min(cells, (int)((screenWidth - 2 * startX) / cellWidth));
+
+        // Probes taken so far; the current one is brightest
+        std::vector<Color>& colors = searchCellColors;
+        colors.assign(visible, SKYBLUE);
+        const std::vector<SearchProbe>& probes = searchProbes[l];
+        int shown = std::min(searchStep + 1, (int)probes.size());
+        for (int p = 0; p < shown; p++) {
+            Color c = (p == shown - 1 && searchAnimating) ? ORANGE : GOLD;
+            for (int s = probes[p].slot; s < probes[p].slot + probes[p].count && s < visible; s++)
+                colors[s] = c;
+        }
+        int result = searchResult[l];
+        if (!searchAnimating && !probes.empty() && result >= 0 && result < visible)
+            colors[result] = data[result] == searchValue ? GREEN : RED;
+
+        for (int i = 0; i < visible; i++) {
+            float x = startX + i * cellWidth;
+            DrawRectangle(x, y, cellWidth, boxHeight, colors[i]);
+            DrawRectangleLines(x, y, cellWidth, boxHeight, DARKBLUE);
+            if (cellWidth >= 30.0f)
+                DrawText(TextFormat("%d", data[i]), x + 5, y + 10, 20, BLACK);
+        }
+
+        // Block boundaries make the B-tree layout readable
+        if (layout == LAYOUT_BTREE) {
+            for (int i = 0; i <= visible; i += SortedArraySearch::blockSize)
+                DrawLineEx({ startX + i * cellWidth, y - 5 }, { startX + i * cellWidth, y + boxHeight + 5 }, 3, DARKGRAY);
+        }
+
+        const char* label = SortedArraySearch::LayoutName(layout);
+        if (lookupsMeasured)
+            label = TextFormat("%s   %.1f ns/lookup (%s)   %.1f ns/lookup (%s)", label,
+                nsPerLookup[l][KERNEL_BRANCHLESS], SortedArraySearch::KernelName(KERNEL_BRANCHLESS),
+                nsPerLookup[l][KERNEL_SIMD], SortedArraySearch::KernelName(KERNEL_SIMD));
+        DrawText(label, startX, y - 30, 20, DARKGRAY);
+    }
+}
+
+
 void ArrayVisualizer::Draw() {
+    ProfileScope scope(PHASE_DRAW);
+    if (searchMode) {
+        DrawSearchLayouts();
+        return;
+    }
+
     if (maxSize <= 0) return; // Dont draw anything until array size is set
 
     float startX = 50.0f;
     float startY = screenHeight / 2.0f;
+
+    // Chart views draw the whole array; scrolling only moves the boxes
+    if (view != VIEW_BOXES) {
+        chart.Draw();
+        DrawText("Array Visualization", startX, startY - 100, 24, DARKGRAY);
+        return;
+    }
     float boxWidth = 60.0f;
     float boxHeight = 40.0f;
     float spacing = 80.0f;
 
     // --- Draw array slots ---
-    for (int i = 0; i < maxSize; i++) {
-        float x = startX + i * spacing;
-        DrawRectangleLines(x, startY, boxWidth, boxHeight, GRAY);
-        DrawText(TextFormat("%d", i), x + 20, startY + boxHeight + 10, 18, DARKGRAY);
+    // While growing, the old block fades out once the new one below has been
+    // filled, and the new block then slides up into its place
+    // Only the slots in the visible window are drawn
+    size_t lastSlot = firstSlot + VisibleSlots();
+    float oldAlpha = reallocating ? 1.0f - reallocSlide : 1.0f;
+    for (size_t i = firstSlot; i < std::min(lastSlot, (size_t)maxSize); i++) {
+        float x = startX + (i - firstSlot) * spacing;
+        DrawRectangleLines(x, startY, boxWidth, boxHeight, Fade(GRAY, oldAlpha));
+        DrawText(TextFormat("%d", (int)i), x + 20, startY + boxHeight + 10, 18, Fade(DARKGRAY, oldAlpha));
+    }
+    if (reallocating) {
+        float newY = startY + 130.0f * (1.0f - reallocSlide);
+        for (size_t i = firstSlot; i < std::min(lastSlot, (size_t)newCapacity); i++)
+            DrawRectangleLines(startX + (i - firstSlot) * spacing, newY, boxWidth, boxHeight, DARKGREEN);
+        DrawText(TextFormat("new block: %d slots", newCapacity), startX, newY + boxHeight + 10, 18, DARKGREEN);
     }
 
     // --- Draw actual elements ---
-    for (auto& e : elements) {
+    size_t endSlot = std::min(lastSlot, elements.Size());
+    for (size_t i = elements.NextOccupied(firstSlot, endSlot); i < endSlot; i = elements.NextOccupied(i + 1, endSlot)) {
+        const AnimatedElement& e = *elements.Find(i);
+        float x = startX + (i - firstSlot) * spacing;
         // Fade highlight color over time
         Color color = SKYBLUE;
-        if (e.highlightTimer > 0.0f) {
-            float t = e.highlightTimer / 0.5f; // normalize to [0,1]
-            color = ColorAlpha(YELLOW, t);     // brighter at first, fading out
+        if (e.highlight > 0.0f) {
+            color = ColorAlpha(YELLOW, e.highlight); // brighter at first, fading out
+        }
+        else if (e.compare > 0.0f) {
+            color = ORANGE;
         }
 
-        DrawRectangle(e.x, e.y, boxWidth, boxHeight, color);
-        DrawRectangleLines(e.x, e.y, boxWidth, boxHeight, DARKBLUE);
-        DrawText(std::to_string(e.value).c_str(), e.x + 15, e.y + 10, 20, BLACK);
+        DrawRectangle(x, e.y, boxWidth, boxHeight, color);
+        DrawRectangleLines(x, e.y, boxWidth, boxHeight, DARKBLUE);
+        DrawText(TextFormat("%d", e.value), x + 15, e.y + 10, 20, BLACK);
+        cacheView.DrawMarker({ x - 4, e.y - 4, boxWidth + 8, boxHeight + 8 }, i);
     }
 
     // Optional title
     DrawText("Array Visualization", startX, startY - 60, 24, DARKGRAY);
+    if ((size_t)maxSize > VisibleSlots())
+        DrawText(TextFormat("Slots %d-%d of %d (mouse wheel or arrow keys to scroll)", (int)firstSlot,
+            (int)std::min(lastSlot, (size_t)maxSize) - 1, maxSize), startX + 300, startY - 56, 20, DARKGRAY);
 }
 
 
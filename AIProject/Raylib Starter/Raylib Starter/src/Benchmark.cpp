@@ -0,0 +1,868 @@
+#include "Benchmark.h"
+#include "ArrayChart.h"
+#include "ArrayHistory.h"
+#include "ArrayVisualizer.h"
+#include "BinaryTree.h"
+#include "CacheSim.h"
+#include "Exporter.h"
+#include "FramePacer.h"
+#include "GrowthPolicy.h"
+#include "SortedArraySearch.h"
+#include "SortKernels.h"
+#include "SparseArray.h"
+#include "Sorting.h"
+#include "globals.h"
+#include "JobSystem.h"
+#include "LinkedList.h"
+#include "TreeHistory.h"
+#include "TweenEngine.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <thread>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// BenchTimer
+// -----------------------------------------------------------------------------
+static bool useCounters = false;
+
+BenchTimer::BenchTimer(const char* label, size_t ops)
+    : label(label), ops(ops), stopped(false), seconds(0.0), counting(false) {
+    if (useCounters) counting = counters.Open();
+    if (counting) counters.Start();
+    start = std::chrono::steady_clock::now();
+}
+
+BenchTimer::~BenchTimer() {
+    Stop();
+}
+
+double BenchTimer::Stop() {
+    if (stopped) return seconds;
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (counting) counters.Stop();
+    stopped = true;
+
+    double nsPerOp = ops ? seconds * 1e9 / ops : 0.0;
+    double opsPerSec = seconds > 0.0 ? ops / seconds : 0.0;
+    printf("  %-36s %10.2f ns/op %14.0f ops/s\n", label, nsPerOp, opsPerSec);
+
+    if (counting && ops) {
+        printf("  %36s", "per op:");
+        for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+            PerfCounter counter = (PerfCounter)c;
+            if (counters.Has(counter))
+                printf("  %s %.2f", PerfCounters::Name(counter), (double)counters.Value(counter) / ops);
+        }
+        if (counters.Has(PERF_CYCLES) && counters.Has(PERF_INSTRUCTIONS) && counters.Value(PERF_CYCLES))
+            printf("  IPC %.2f", (double)counters.Value(PERF_INSTRUCTIONS) / counters.Value(PERF_CYCLES));
+        printf("\n");
+    }
+    return seconds;
+}
+
+// -----------------------------------------------------------------------------
+// AllocationBudget
+// -----------------------------------------------------------------------------
+static bool budgetExceeded = false;
+
+AllocationBudget::AllocationBudget(const char* label, uint64_t budget)
+    : label(label), budget(budget), checked(false), passed(true),
+      start(GetAllocationStats()) {
+}
+
+AllocationBudget::~AllocationBudget() {
+    Check();
+}
+
+bool AllocationBudget::Check() {
+    if (checked) return passed;
+    AllocationStats now = GetAllocationStats();
+    checked = true;
+
+    uint64_t allocations = now.allocations - start.allocations;
+    passed = allocations <= budget;
+    printf("  %-36s %10llu allocs (budget %llu)%s\n", label, (unsigned long long)allocations,
+        (unsigned long long)budget, passed ? "" : "  ALLOCATION BUDGET EXCEEDED");
+    if (!passed) budgetExceeded = true;
+    return passed;
+}
+
+// -----------------------------------------------------------------------------
+// Benchmarks
+// -----------------------------------------------------------------------------
+static void BenchTreeBatchSearch() {
+    const int nodeCount = 1000000;
+    const int queryCount = 1000000;
+
+    // Shuffled distinct keys give a random (roughly balanced) BST
+    std::mt19937 rng(42);
+    std::vector<int> keys(nodeCount);
+    for (int i = 0; i < nodeCount; i++) keys[i] = i * 2;
+    std::shuffle(keys.begin(), keys.end(), rng);
+
+    BinaryTree tree(screenWidth, screenHeight);
+    for (int key : keys) tree.InsertImmediate(key);
+
+    // Odd queries miss, even ones hit
+    std::vector<int> queries(queryCount);
+    std::uniform_int_distribution<int> dist(0, nodeCount * 2 - 1);
+    for (int& q : queries) q = dist(rng);
+
+    long long sequentialSum = 0;
+    BenchTimer sequential("tree search (sequential)", queryCount);
+    for (int q : queries) {
+        int length = 0;
+        sequentialSum += tree.Contains(q, &length) ? length : -length;
+    }
+    double sequentialSeconds = sequential.Stop();
+
+    std::vector<BatchSearchResult> results(queryCount);
+    BenchTimer batched("tree search (batched, 16 lanes)", queryCount);
+    tree.SearchBatch(queries.data(), queries.size(), results.data());
+    double batchedSeconds = batched.Stop();
+
+    long long batchedSum = 0;
+    for (const BatchSearchResult& r : results)
+        batchedSum += r.found ? r.pathLength : -r.pathLength;
+
+    printf("  speedup %.2fx, results %s\n", sequentialSeconds / batchedSeconds,
+        sequentialSum == batchedSum ? "match" : "MISMATCH");
+}
+
+static void BenchSortedSearch() {
+    const int sizes[] = { 1 << 10, 1 << 16, 1 << 20, 1 << 24 };
+    const int queryCount = 1 << 22;
+    std::mt19937 rng(7);
+
+    for (int n : sizes) {
+        std::vector<int> keys(n);
+        for (int i = 0; i < n; i++) keys[i] = i * 3;
+        SortedArraySearch search;
+        search.Build(keys);
+
+        std::uniform_int_distribution<int> dist(-1, n * 3);
+        std::vector<int> queries(queryCount);
+        for (int& q : queries) q = dist(rng);
+
+        printf(" %d keys (%d KiB)\n", n, (int)(n * sizeof(int) / 1024));
+        std::vector<int> expected(queryCount), slots(queryCount);
+        search.FindBatch(queries.data(), expected.data(), queryCount, LAYOUT_SORTED, KERNEL_BRANCHLESS);
+
+        for (int l = 0; l < LAYOUT_COUNT; l++) {
+            for (int k = 0; k < KERNEL_COUNT; k++) {
+                SearchLayout layout = (SearchLayout)l;
+                SearchKernel kernel = (SearchKernel)k;
+                char label[64];
+                snprintf(label, sizeof(label), "%s (%s)", SortedArraySearch::LayoutName(layout),
+                    SortedArraySearch::KernelName(kernel));
+
+                BenchTimer timer(label, queryCount);
+                search.FindBatch(queries.data(), slots.data(), queryCount, layout, kernel);
+                timer.Stop();
+
+                // Every layout must agree on the key found
+                for (int i = 0; i < queryCount; i++) {
+                    int want = expected[i] < 0 ? -1 : search.Data(LAYOUT_SORTED)[expected[i]];
+                    int got = slots[i] < 0 ? -1 : search.Data(layout)[slots[i]];
+                    if (want != got) {
+                        printf("  MISMATCH for query %d\n", queries[i]);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void BenchSort() {
+    const size_t count = 10000000;
+    std::mt19937 rng(11);
+    std::vector<int> input(count);
+    for (int& v : input) v = (int)rng();
+
+    std::vector<int> data;
+    for (int a = 0; a < SORT_COUNT; a++) {
+        SortAlgorithm algorithm = (SortAlgorithm)a;
+
+        // Insertion sort is quadratic; time it on a slice instead
+        size_t n = algorithm == SORT_INSERTION ? 50000 : count;
+        data.assign(input.begin(), input.begin() + n);
+
+        char label[64];
+        snprintf(label, sizeof(label), "%s (%d elements)", SortName(algorithm), (int)n);
+        BenchTimer timer(label, n);
+        Sort(algorithm, data.data(), n);
+        timer.Stop();
+
+        if (!std::is_sorted(data.begin(), data.end()))
+            printf("  NOT SORTED\n");
+    }
+}
+
+static void BenchSortKernels() {
+    const size_t sizes[] = { 1000000, 10000000, 100000000 };
+    const char* distributions[] = { "uniform", "sorted", "reversed", "few-unique" };
+    std::mt19937 rng(13);
+    printf("  kernels use %s\n", SortKernelIsa());
+
+    std::vector<int> input, data;
+    for (size_t n : sizes) {
+        for (int d = 0; d < 4; d++) {
+            input.resize(n);
+            for (size_t i = 0; i < n; i++) {
+                if (d == 0) input[i] = (int)rng();
+                else if (d == 1) input[i] = (int)i;
+                else if (d == 2) input[i] = (int)(n - i);
+                else input[i] = (int)(rng() % 16);
+            }
+            printf(" %s, %d elements\n", distributions[d], (int)n);
+
+            struct { const char* name; void (*sort)(int*, size_t); } sorts[] = {
+                { "std::sort", [](int* a, size_t count) { std::sort(a, a + count); } },
+                { "radix (parallel, SIMD)", RadixSortParallel },
+                { "quicksort (vector partition)", QuickSortVectorized },
+            };
+            for (auto& sort : sorts) {
+                data = input;
+                BenchTimer timer(sort.name, n);
+                sort.sort(data.data(), n);
+                timer.Stop();
+                if (!std::is_sorted(data.begin(), data.end())) printf("  NOT SORTED\n");
+            }
+        }
+    }
+}
+
+static void BenchJobScaling() {
+    const size_t count = 1000000;
+    const int frames = 200;
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    printf("  %u hardware threads\n", hardware);
+
+    // Tweens this long keep every value moving for the whole run
+    std::vector<float> values(count, 0.0f);
+    TweenEngine tweens;
+    for (size_t i = 0; i < count; i++) tweens.Add(&values[i], 1.0f, 1e9f);
+
+    // 1, 2, 4, ... threads, ending with every hardware thread
+    std::vector<unsigned> threadCounts;
+    for (unsigned t = 1; t < hardware; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(hardware);
+
+    double oneThread = 0.0;
+    for (unsigned threads : threadCounts) {
+        JobSystem jobs(threads);
+        char label[64];
+        snprintf(label, sizeof(label), "tween update, %u thread%s", threads, threads == 1 ? "" : "s");
+
+        BenchTimer timer(label, count * frames);
+        for (int f = 0; f < frames; f++) tweens.Tick(1.0f / 60.0f, jobs);
+        double seconds = timer.Stop();
+        if (threads == 1) oneThread = seconds;
+        else printf("  scaling %.2fx on %u threads\n", oneThread / seconds, threads);
+    }
+}
+
+static void BenchTweens() {
+    const size_t count = 1000000;
+    const int frames = 200;
+    const Easing easings[] = { EASE_LINEAR, EASE_OUT_QUAD, EASE_OUT_CUBIC };
+    printf("  SIMD kernel uses %s\n", TweenEngine::KernelIsa());
+
+    // One thread, so the numbers compare kernels rather than the pool
+    JobSystem jobs(1);
+    std::vector<float> values(count);
+    for (int scalar = 1; scalar >= 0; scalar--) {
+        const char* kernel = scalar ? "scalar" : TweenEngine::KernelIsa();
+        char label[64];
+
+        // Steady state: tweens this long never settle during the run
+        TweenEngine tweens;
+        tweens.SetScalarKernel(scalar != 0);
+        for (size_t i = 0; i < count; i++) {
+            values[i] = 0.0f;
+            tweens.Add(&values[i], 1.0f, 1e9f, easings[i % 3]);
+        }
+        snprintf(label, sizeof(label), "tween tick, %s", kernel);
+        BenchTimer steady(label, count * frames);
+        for (int f = 0; f < frames; f++) tweens.Tick(1.0f / 60.0f, jobs);
+        steady.Stop();
+
+        // Settling: durations spread over a second, ticked until all are removed
+        tweens.Clear();
+        for (size_t i = 0; i < count; i++) {
+            values[i] = 0.0f;
+            tweens.Add(&values[i], (float)i, 0.1f + 0.9f * (i % 997) / 996.0f, easings[i % 3]);
+        }
+        size_t updates = 0;
+        snprintf(label, sizeof(label), "tween settle, %s", kernel);
+        BenchTimer settle(label, 0);
+        while (tweens.Count() > 0) {
+            updates += tweens.Count();
+            tweens.Tick(1.0f / 60.0f, jobs);
+        }
+        settle.SetOps(updates);
+        settle.Stop();
+
+        for (size_t i = 0; i < count; i++) {
+            if (values[i] != (float)i) {
+                printf("  WRONG VALUE at %zu\n", i);
+                break;
+            }
+        }
+    }
+}
+
+static void BenchTreeLayout() {
+    const int nodeCount = 10000000;
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> dist(0, 2000000000);
+
+    printf("  building %d-node tree\n", nodeCount);
+    BinaryTree tree(screenWidth, screenHeight);
+    for (int i = 0; i < nodeCount; i++) tree.InsertImmediate(dist(rng));
+
+    JobSystem serial(1);
+    JobSystem& parallel = GetJobSystem();
+    const TreeLayout layouts[] = { TREE_LAYOUT_MIDPOINT, TREE_LAYOUT_COMPACT };
+    const char* names[] = { "midpoint", "compact" };
+
+    for (int l = 0; l < 2; l++) {
+        // SetLayout itself lays out on the shared pool; the timed runs follow
+        tree.SetLayout(layouts[l]);
+
+        char label[64];
+        snprintf(label, sizeof(label), "%s layout, 1 thread", names[l]);
+        BenchTimer one(label, nodeCount);
+        tree.Relayout(serial);
+        double oneSeconds = one.Stop();
+
+        unsigned threads = parallel.ThreadCount();
+        snprintf(label, sizeof(label), "%s layout, %u thread%s", names[l], threads, threads == 1 ? "" : "s");
+        BenchTimer many(label, nodeCount);
+        tree.Relayout(parallel);
+        double manySeconds = many.Stop();
+
+        printf("  speedup %.2fx\n", oneSeconds / manySeconds);
+    }
+}
+
+// A settled scene must animate without touching the heap
+static void BenchIdleFrame() {
+    const int frames = 1000;
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<int> dist(0, 999);
+
+    BinaryTree tree(screenWidth, screenHeight);
+    for (int i = 0; i < 200; i++) tree.InsertImmediate(dist(rng));
+    LinkedList list;
+    for (int i = 0; i < 20; i++) list.AddNode(i);
+    ArrayVisualizer array(screenWidth, screenHeight);
+
+    // Let the scene settle and any lazily grown buffers reach their size
+    for (int f = 0; f < 600; f++) {
+        tree.UpdateAnimations();
+        list.UpdateAnimations();
+        array.UpdateAnimations();
+    }
+
+    AllocationBudget budget("idle frames (tree, list, array)", 0);
+    BenchTimer timer("idle frame update", frames);
+    for (int f = 0; f < frames; f++) {
+        tree.UpdateAnimations();
+        list.UpdateAnimations();
+        array.UpdateAnimations();
+    }
+    timer.Stop();
+    budget.Check();
+}
+
+static void PrintCacheReplay(const char* label, const CacheSimulator& cache) {
+    printf("  %-28s %7llu lines", label, (unsigned long long)cache.LineAccesses());
+    for (int i = 0; i < cache.LevelCount(); i++) {
+        const CacheLevelStats& s = cache.Stats(i);
+        uint64_t total = s.hits + s.misses;
+        printf("  %s miss %5.1f%%", cache.Level(i).name, total ? 100.0 * s.misses / total : 0.0);
+    }
+    printf("  mem %llu\n", (unsigned long long)cache.MemoryAccesses());
+}
+
+// Replays one operation on each structure through the desktop hierarchy.
+// Every row is a single operation; miss ratios are local to each level.
+static void BenchCacheSim() {
+    const int count = 20000;
+    std::mt19937 rng(11);
+    std::vector<int> values(count);
+    for (int i = 0; i < count; i++) values[i] = i * 2;
+    std::shuffle(values.begin(), values.end(), rng);
+
+    ArrayVisualizer array(screenWidth, screenHeight);
+    array.SetValues(values);
+
+    // Appended nodes come out of the allocator back to back; nodes inserted
+    // at random positions end up in list order that jumps around the heap
+    LinkedList appended;
+    for (int v : values) appended.AddNode(v);
+    LinkedList scattered;
+    for (int i = 0; i < count; i++)
+        scattered.InsertNodeAt(std::uniform_int_distribution<int>(0, i)(rng), values[i]);
+
+    BinaryTree tree(screenWidth, screenHeight);
+    for (int v : values) tree.InsertImmediate(v);
+
+    CacheSimulator cache(cachePresets[0]);
+    AddressTrace trace;
+    std::vector<int8_t> elementLevels;
+    for (int op = 0; op < CACHE_TRACE_OP_COUNT; op++) {
+        // A missing key scans everything; inserts go in the middle
+        CacheTraceOp traceOp = (CacheTraceOp)op;
+        int key = traceOp == CACHE_TRACE_SEARCH ? -1 : count / 2;
+        printf(" %s, %d elements\n", CacheTraceOpName(traceOp), count);
+
+        for (bool warm : { false, true }) {
+            char label[64];
+            struct Row { const char* name; int which; };
+            const Row rows[] = { { "array", 0 }, { "list (appended)", 1 }, { "list (scattered)", 2 }, { "tree", 3 } };
+            for (const Row& row : rows) {
+                trace.clear();
+                if (row.which == 0) array.TraceOperation(traceOp, key, trace);
+                else if (row.which == 1) appended.TraceOperation(traceOp, key, trace);
+                else if (row.which == 2) scattered.TraceOperation(traceOp, key, trace);
+                else tree.TraceOperation(traceOp, traceOp == CACHE_TRACE_INSERT ? -1 : key, trace);
+
+                cache.Replay(trace, warm, elementLevels);
+                snprintf(label, sizeof(label), "%s, %s", row.name, warm ? "warm" : "cold");
+                PrintCacheReplay(label, cache);
+            }
+        }
+    }
+}
+
+// Frees `count` blocks of `bytes` in random order so the allocator hands the
+// next allocations of that size out scattered, like a heap that has been in
+// use for a while
+static void AgeHeap(size_t count, size_t bytes, std::mt19937& rng) {
+    std::vector<char*> blocks(count);
+    for (char*& block : blocks) block = new char[bytes];
+    std::shuffle(blocks.begin(), blocks.end(), rng);
+    for (char* block : blocks) delete[] block;
+}
+
+// Pointer chasing over nodes from operator new on an aged heap, then over
+// the same nodes copied into a NodePool in logical order
+static void BenchNodeLayout() {
+    const int count = 1 << 20;
+    std::mt19937 rng(13);
+    std::uniform_int_distribution<int> dist(0, 1 << 30);
+
+    AgeHeap(count, sizeof(Node), rng);
+    LinkedList list;
+    for (int i = 0; i < count; i++) list.AddNode(i);
+    for (int f = 0; f < 120; f++) list.UpdateAnimations(); // land the nodes so the links are set
+
+    long long sums[2] = {};
+    for (int pooled = 0; pooled < 2; pooled++) {
+        list.SetPooled(pooled != 0);
+        char label[64];
+        snprintf(label, sizeof(label), "list walk (%s)", pooled ? "pool" : "new");
+        BenchTimer timer(label, count);
+        sums[pooled] = list.SumValues();
+        timer.Stop();
+        printf("  %36s %.1f MiB footprint\n", "", list.FootprintBytes() / (1024.0 * 1024.0));
+    }
+    printf("  sums %s\n", sums[0] == sums[1] ? "match" : "MISMATCH");
+
+    AgeHeap(count, sizeof(TreeNode), rng);
+    BinaryTree tree(screenWidth, screenHeight);
+    for (int i = 0; i < count; i++) tree.InsertImmediate(dist(rng));
+
+    std::vector<int> queries(count);
+    for (int& q : queries) q = dist(rng);
+    int found[2] = {};
+    for (int pooled = 0; pooled < 2; pooled++) {
+        tree.SetPooled(pooled != 0);
+        char label[64];
+        snprintf(label, sizeof(label), "tree search (%s)", pooled ? "pool" : "new");
+        BenchTimer timer(label, count);
+        for (int q : queries) found[pooled] += tree.Contains(q);
+        timer.Stop();
+        printf("  %36s %.1f MiB footprint\n", "", tree.FootprintBytes() / (1024.0 * 1024.0));
+    }
+    printf("  results %s\n", found[0] == found[1] ? "match" : "MISMATCH");
+}
+
+// Pushes `count` ints into v. With a policy, a full vector is grown by
+// reserving what the policy asks for; GROWTH_FIXED leaves growth to the
+// standard library. Prints the time plus what the reallocations cost.
+static void RunGrowth(const char* label, size_t count, GrowthPolicy policy, size_t reserved) {
+    std::vector<int> v;
+    v.reserve(reserved);
+
+    size_t reallocations = 0, bytesCopied = 0;
+    size_t peakBytes = v.capacity() * sizeof(int);
+    BenchTimer timer(label, count);
+    for (size_t i = 0; i < count; i++) {
+        size_t capacity = v.capacity();
+        if (v.size() == capacity && policy != GROWTH_FIXED) v.reserve(GrowCapacity(policy, capacity));
+        v.push_back((int)i);
+
+        // Old and new blocks are both live while the elements move
+        if (v.capacity() != capacity) {
+            reallocations++;
+            bytesCopied += i * sizeof(int);
+            peakBytes = std::max(peakBytes, (capacity + v.capacity()) * sizeof(int));
+        }
+    }
+    timer.Stop();
+    printf("  %36s %zu reallocs, %.1f MiB copied (%.2f bytes/push), peak %.1f MiB\n", "", reallocations,
+        bytesCopied / (1024.0 * 1024.0), (double)bytesCopied / count, peakBytes / (1024.0 * 1024.0));
+}
+
+static void BenchVectorGrowth() {
+    const size_t count = 10000000;
+    RunGrowth("std::vector, reserve(n)", count, GROWTH_FIXED, count);
+    RunGrowth("std::vector, no reserve", count, GROWTH_FIXED, 0);
+    RunGrowth("1.5x growth", count, GROWTH_1_5X, 0);
+    RunGrowth("2x growth", count, GROWTH_2X, 0);
+
+    // Quadratic: 10M pushes would copy ~200 TB
+    RunGrowth("exact fit (30000 pushes)", 30000, GROWTH_EXACT, 0);
+}
+
+static void BenchSparseArray() {
+    const size_t slots = 1000000000;
+    const size_t writes = 1000;
+    std::mt19937_64 rng(11);
+    std::uniform_int_distribution<size_t> dist(0, slots - 1);
+
+    // What Set At Index 5,000,000 used to do: fill placeholders up to it
+    {
+        BenchTimer timer("dense placeholders up to 5M", 1);
+        std::vector<AnimatedElement> dense(5000001);
+        dense.back().value = 1;
+        timer.Stop();
+    }
+
+    SparseArray<AnimatedElement> elements;
+    {
+        BenchTimer timer("sparse writes over 1e9 slots", writes);
+        for (size_t i = 0; i < writes; i++) elements.Set(dist(rng), AnimatedElement((int)i));
+        timer.Stop();
+    }
+    printf("  %36s %zu pages, %.1f MiB\n", "", elements.PageCount(), elements.FootprintBytes() / (1024.0 * 1024.0));
+
+    // Every occupied slot, then one screen-sized window at random places
+    size_t found = 0;
+    {
+        BenchTimer timer("walk occupied slots", writes);
+        for (size_t i = elements.NextOccupied(0); i < elements.Size(); i = elements.NextOccupied(i + 1)) found++;
+        timer.Stop();
+    }
+    if (found != elements.OccupiedCount()) printf("  WALK FOUND %zu OF %zu\n", found, elements.OccupiedCount());
+
+    const size_t windows = 100000;
+    size_t drawn = 0;
+    BenchTimer timer("visible window of 20 slots", windows);
+    for (size_t w = 0; w < windows; w++) {
+        size_t first = dist(rng);
+        size_t end = std::min(first + 20, elements.Size());
+        for (size_t i = elements.NextOccupied(first, end); i < end; i = elements.NextOccupied(i + 1, end)) drawn++;
+    }
+    timer.Stop();
+    printf("  %36s %zu elements in view\n", "", drawn);
+}
+
+// A sort of 1M elements replayed at the visualizer's pace (the whole trace in
+// eight seconds of 60 FPS frames) into the chart, CPU side only: per frame
+// either the written columns are redrawn, or the whole chart is rebuilt
+static void BenchArrayChart() {
+    const size_t count = 1000000;
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> dist(0, 999);
+    std::vector<int> values(count);
+    for (int& v : values) v = dist(rng);
+
+    std::vector<int> sorted = values;
+    SortTrace trace;
+    Sort(SORT_INTROSORT, sorted.data(), count, &trace);
+    const size_t frames = 8 * 60;
+    size_t perFrame = trace.events.size() / frames + 1;
+    printf("  %36s %zu events, %zu per frame\n", "", trace.events.size(), perFrame);
+
+    for (int full = 0; full < 2; full++) {
+        ArrayChart chart({ 0, 0, (float)(screenWidth - 100), 300 });
+        std::vector<int> data = values;
+        chart.Reset(count);
+        for (size_t i = 0; i < count; i++) chart.Add(i, data[i]);
+        chart.Update();
+
+        BenchTimer timer(full ? "frame, full rebuild" : "frame, dirty columns", frames);
+        for (size_t begin = 0; begin < trace.events.size(); begin += perFrame) {
+            size_t end = std::min(begin + perFrame, trace.events.size());
+            for (size_t k = begin; k < end; k++) {
+                const SortEvent& e = trace.events[k];
+                if (e.op == SORT_OP_SWAP) {
+                    int a = data[e.index], b = data[e.other];
+                    data[e.index] = b;
+                    data[e.other] = a;
+                    if (!full) {
+                        chart.Write(e.index, a, b);
+                        chart.Write(e.other, b, a);
+                    }
+                }
+                else if (e.op == SORT_OP_WRITE) {
+                    if (!full) chart.Write(e.index, data[e.index], e.other);
+                    data[e.index] = e.other;
+                }
+            }
+            if (full) {
+                chart.Reset(count);
+                for (size_t i = 0; i < count; i++) chart.Add(i, data[i]);
+            }
+            chart.Update();
+        }
+        timer.Stop();
+        if (data != sorted) printf("  REPLAY DID NOT SORT\n");
+    }
+}
+
+// One version per insert and delete: what a version stores, and what stepping
+// between neighbouring versions has to look at
+static void BenchTreeHistory() {
+    const int inserts = 100000, deletes = 20000;
+    std::mt19937 rng(13);
+    std::uniform_int_distribution<int> dist(0, 9999999);
+
+    TreeHistory history;
+    std::vector<int> keys;
+    {
+        BenchTimer timer("insert, one version each", inserts);
+        for (int i = 0; i < inserts; i++) {
+            int key = dist(rng);
+            keys.push_back(key);
+            history.BeginEdit(TREE_OP_INSERT, key);
+            history.Insert(key);
+            history.EndEdit();
+        }
+        timer.Stop();
+    }
+    {
+        std::shuffle(keys.begin(), keys.end(), rng);
+        BenchTimer timer("delete, one version each", deletes);
+        for (int i = 0; i < deletes; i++) {
+            uint32_t removed;
+            history.BeginEdit(TREE_OP_DELETE, keys[i]);
+            history.Remove(keys[i], &removed);
+            history.EndEdit();
+        }
+        timer.Stop();
+    }
+    size_t versions = history.VersionCount() - 1;
+    printf("  %36s %zu versions: %zu nodes stored, %.1f per version (full copies: %zu), %.1f MiB\n", "",
+        versions, history.StoredNodes(), (double)history.StoredNodes() / versions, history.SnapshotNodes(),
+        history.FootprintBytes() / (1024.0 * 1024.0));
+
+    // Walk the whole timeline back one version at a time
+    std::vector<const VersionNode*> leaving, entering;
+    size_t walked = 0;
+    BenchTimer timer("step back one version (select + diff)", versions);
+    for (size_t v = versions; v-- > 0;) {
+        const VersionNode* before = history.Root();
+        history.Select(v);
+        leaving.clear();
+        entering.clear();
+        TreeHistory::Diff(before, history.Root(), leaving, entering);
+        walked += leaving.size() + entering.size();
+    }
+    timer.Stop();
+    printf("  %36s %.1f nodes compared per step\n", "", (double)walked / versions);
+}
+
+// The first 100k steps of sorting 1M elements recorded, then scrubbed: one
+// step at a time back to the start, and jumps between the ends and the middle
+static void BenchArrayHistory() {
+    const size_t count = 1000000, steps = 100000;
+    std::mt19937 rng(17);
+    std::vector<int> data(count);
+    for (int& v : data) v = (int)(rng() % 1000000);
+
+    std::vector<int> sorted = data;
+    SortTrace trace;
+    Sort(SORT_INTROSORT, sorted.data(), count, &trace);
+
+    ArrayHistory history;
+    history.Reset(data, std::vector<bool>(count, true));
+    {
+        BenchTimer timer("record sort steps", steps);
+        for (size_t k = 0; k < trace.events.size() && history.NewestStep() < steps; k++) {
+            const SortEvent& e = trace.events[k];
+            if (e.op == SORT_OP_SWAP) {
+                std::swap(data[e.index], data[e.other]);
+                history.Record(e.index, { true, data[e.other] }, { true, data[e.index] });
+                history.Record(e.other, { true, data[e.index] }, { true, data[e.other] });
+            }
+            else if (e.op == SORT_OP_WRITE) {
+                history.Record(e.index, { true, data[e.index] }, { true, e.other });
+                data[e.index] = e.other;
+            }
+            history.EndStep();
+        }
+        timer.Stop();
+    }
+    double arrayBytes = count * sizeof(int);
+    printf("  %36s %zu checkpoints, chunks %.2fx the array, %.1f MiB in all (%.2fx)\n", "",
+        history.CheckpointCount(), (double)history.StoredChunks() / history.ArrayChunks(),
+        history.FootprintBytes() / (1024.0 * 1024.0), history.FootprintBytes() / arrayBytes);
+
+    size_t changed = 0;
+    auto apply = [&](size_t, ArrayHistory::Slot) { changed++; };
+    {
+        BenchTimer timer("step back one step", steps);
+        for (size_t s = history.NewestStep(); s-- > 0;) history.Seek(s, apply);
+        timer.Stop();
+    }
+    const int jumps = 100;
+    BenchTimer timer("jump start <-> middle <-> newest", jumps * 2);
+    for (int j = 0; j < jumps; j++) {
+        history.Seek(j % 2 ? 0 : history.NewestStep(), apply);
+        history.Seek(history.NewestStep() / 2, apply);
+    }
+    timer.Stop();
+    printf("  %36s %zu slot updates\n", "", changed);
+}
+
+static void BenchFrameEncode() {
+    // Export-sized frames with a moving gradient: something the GIF quantizer
+    // has to work at, a little different every frame
+    const int width = 800, height = 450;
+    const int frames = 120;
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<uint8_t> pixels((size_t)width * height * 4);
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+
+    for (int format = EXPORT_GIF; format <= EXPORT_PNG; format++) {
+        std::string path = (dir / (format == EXPORT_GIF ? "bench-export.gif" : "bench-export")).string();
+        double oneThread = 0.0;
+        for (int run = 0; run < (hardware > 1 ? 2 : 1); run++) {
+            unsigned threads = run ? hardware : 1;
+            char label[64];
+            snprintf(label, sizeof(label), "%s encode, %u thread%s", format == EXPORT_GIF ? "gif" : "png",
+                threads, threads == 1 ? "" : "s");
+
+            BenchTimer timer(label, frames);
+            FrameEncoder encoder((ExportFormat)format, path, width, height, 50.0f, threads);
+            for (int f = 0; f < frames; f++) {
+                for (int y = 0; y < height; y++)
+                    for (int x = 0; x < width; x++) {
+                        uint8_t* p = &pixels[((size_t)y * width + x) * 4];
+                        p[0] = (uint8_t)(x + f);
+                        p[1] = (uint8_t)(y + 2 * f);
+                        p[2] = (uint8_t)((x ^ y) + f);
+                        p[3] = 255;
+                    }
+                encoder.Submit(pixels.data());
+            }
+            bool ok = encoder.Finish();
+            double seconds = timer.Stop();
+            if (!ok) printf("  %36s write to %s failed\n", "", path.c_str());
+            if (threads == 1) oneThread = seconds;
+            else printf("  %36s scaling %.2fx on %u threads\n", "", oneThread / seconds, threads);
+        }
+        std::error_code error;
+        std::filesystem::remove_all(path, error);
+    }
+}
+
+static void BenchFramePacing() {
+    // Two seconds of empty 60 fps frames each way. The spin variant stands in
+    // for raylib's limiter (SUPPORT_PARTIALBUSY_WAIT_LOOP): sleep 95% of what's
+    // left, then spin to the deadline.
+    const int frames = 120;
+    const double fps = 60.0;
+    for (int mode = 0; mode < 2; mode++) {
+        FramePacer pacer(fps);
+        auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / fps));
+        auto deadline = std::chrono::steady_clock::now();
+        for (int f = 0; f <= frames; f++) {
+            if (mode == 0) {
+                pacer.Wait();
+                continue;
+            }
+            deadline += period;
+            auto left = deadline - std::chrono::steady_clock::now();
+            if (left.count() > 0) std::this_thread::sleep_for(left * 95 / 100);
+            while (std::chrono::steady_clock::now() < deadline) {
+            }
+            pacer.Observe();
+        }
+        PacingStats stats = pacer.Stats();
+        printf("  %-36s jitter mean %.3f ms  p99 %.3f  max %.3f  >1 ms %zu/%zu  CPU %.1f%%\n",
+            mode == 0 ? "sleep to deadline" : "sleep + spin", stats.meanJitterMs, stats.p99JitterMs,
+            stats.maxJitterMs, stats.framesOver1Ms, stats.frames, stats.cpuPercent);
+    }
+}
+
+struct BenchmarkEntry {
+    const char* name;
+    void (*run)();
+};
+
+static const BenchmarkEntry benchmarks[] = {
+    { "tree-batch-search", BenchTreeBatchSearch },
+    { "sorted-search", BenchSortedSearch },
+    { "sort", BenchSort },
+    { "sort-kernels", BenchSortKernels },
+    { "job-scaling", BenchJobScaling },
+    { "tweens", BenchTweens },
+    { "tree-layout", BenchTreeLayout },
+    { "idle-frame", BenchIdleFrame },
+    { "cache-sim", BenchCacheSim },
+    { "node-layout", BenchNodeLayout },
+    { "vector-growth", BenchVectorGrowth },
+    { "sparse-array", BenchSparseArray },
+    { "array-chart", BenchArrayChart },
+    { "tree-history", BenchTreeHistory },
+    { "array-history", BenchArrayHistory },
+    { "frame-encode", BenchFrameEncode },
+    { "frame-pacing", BenchFramePacing },
+};
+
+int RunBenchmarks(int argc, char** argv) {
+    SetAllocationTracking(true);
+
+    if (argc > 0 && strcmp(argv[0], "--counters") == 0) {
+        argc--;
+        argv++;
+
+        // Containers commonly block perf_event_open; carry on with timings only
+        PerfCounters probe;
+        useCounters = probe.Open();
+        if (useCounters) printf("hardware counters: %s\n", probe.Reason());
+        else printf("hardware counters unavailable (%s), timing only\n", probe.Reason());
+    }
+
+    int ran = 0;
+    for (const BenchmarkEntry& bench : benchmarks) {
+        // No names given runs everything; otherwise run the named benchmarks
+        bool selected = argc == 0;
+        for (int i = 0; i < argc; i++)
+            if (strcmp(argv[i], bench.name) == 0) selected = true;
+        if (!selected) continue;
+
+        printf("%s\n", bench.name);
+        bench.run();
+        ran++;
+    }
+
+    if (ran == 0) {
+        printf("Unknown benchmark. Available:\n");
+        for (const BenchmarkEntry& bench : benchmarks) printf("  %s\n", bench.name);
+        return 1;
+    }
+    return budgetExceeded ? 1 : 0;
+}
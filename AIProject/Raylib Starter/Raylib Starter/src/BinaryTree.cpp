@@ -1,5 +1,19 @@
 #include "BinaryTree.h"
+#include "Cpu.h"
+#include "FrameClock.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "AllocationTracker.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <climits>
 #include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
 
 BinaryTree::BinaryTree(int width, int height)
     : root(nullptr), screenWidth(width), screenHeight(height)
@@ -9,76 +23,347 @@ BinaryTree::BinaryTree(int width, int height)
     insertBtn = { 270, 100, 150, 40 };
     searchBox = { 50, 170, 200, 40 };
     searchBtn = { 270, 170, 150, 40 };
+    batchBtn = { 440, 170, 150, 40 };
+    skipBtn = { 440, 100, 150, 40 };
+    bulkBtn = { 610, 100, 150, 40 };
+    layoutBtn = { 780, 100, 220, 40 };
+    deleteBtn = { 970, 170, 120, 40 };
+    undoBtn = { 1110, 170, 100, 40 };
+    redoBtn = { 1220, 170, 100, 40 };
+    timeline = { 50, height - 90.0f, width - 100.0f, 12 };
 }
 
-void ResetHighlights(TreeNode* node) {
+BinaryTree::~BinaryTree() {
+    // Stop the worker first so no more nodes arrive
+    worker.Cancel();
+    FreeNode(unlinkedNode);
+
+    // Iterative so very deep (degenerate) trees can't overflow the stack
+    std::vector<TreeNode*> stack;
+    if (root) stack.push_back(root);
+    while (!stack.empty()) {
+        TreeNode* node = stack.back();
+        stack.pop_back();
+        if (node->left) stack.push_back(node->left);
+        if (node->right) stack.push_back(node->right);
+        FreeNode(node);
+    }
+}
+
+TreeNode* BinaryTree::NewNode(const TreeNode& init) {
+    return usePool ? pool.Create(init) : new TreeNode(init);
+}
+
+void BinaryTree::FreeNode(TreeNode* node) {
     if (!node) return;
+    if (usePool) pool.Destroy(node);
+    else delete node;
+}
+
+void BinaryTree::SetPooled(bool pooled) {
+    // The animator, batch paths and bulk insert all hold node pointers
+    if (pooled == usePool || playing || bulkTotal > 0) return;
+
+    // Tweens point into the nodes: let them land first
+    tweens.FinishAll();
+
+    // Pre-order, left first, so a pool keeps every subtree in one run. Old
+    // addresses are only used as keys once the node has been copied.
+    std::unordered_map<TreeNode*, TreeNode*> moved;
+    std::vector<TreeNode*> stack;
+    if (root) stack.push_back(root);
+    while (!stack.empty()) {
+        TreeNode* node = stack.back();
+        stack.pop_back();
+        if (node->right) stack.push_back(node->right);
+        if (node->left) stack.push_back(node->left);
+        moved[node] = pooled ? pool.Create(*node) : new TreeNode(*node);
+        FreeNode(node);
+    }
+    usePool = pooled;
+    if (!pooled) pool.Release();
+
+    auto remap = [&](TreeNode*& node) {
+        if (node) node = moved[node];
+    };
+    for (auto& entry : moved) {
+        remap(entry.second->left);
+        remap(entry.second->right);
+    }
+    remap(root);
+    remap(lastSearchHighlight);
+    for (TreeNode*& node : visualNodes) remap(node);
+    for (TreeNode*& node : batchPaths) remap(node);
+    for (TreeNode*& node : cacheNodes) remap(node);
+    step = {};
+}
+
+void BinaryTree::CollectNodes(std::vector<const void*>& out) const {
+    std::vector<const TreeNode*> stack;
+    const TreeNode* node = root;
+    while (node || !stack.empty()) {
+        while (node) {
+            stack.push_back(node);
+            node = node->left;
+        }
+        node = stack.back();
+        stack.pop_back();
+        out.push_back(node);
+        node = node->right;
+    }
+}
 
-    // Begin fading back to blue instead of instantly resetting
+void BinaryTree::CollectKeys(std::vector<int>& out) const {
+    // From the history, so keys still animating in count too
+    std::vector<const VersionNode*> stack;
+    if (history.Root()) stack.push_back(history.Root());
+    while (!stack.empty()) {
+        const VersionNode* node = stack.back();
+        stack.pop_back();
+        out.push_back(node->value);
+        if (node->right) stack.push_back(node->right);
+        if (node->left) stack.push_back(node->left);
+    }
+}
+
+size_t BinaryTree::FootprintBytes() const {
+    if (usePool) return pool.FootprintBytes();
+    size_t bytes = 0;
+    std::vector<const TreeNode*> stack;
+    if (root) stack.push_back(root);
+    while (!stack.empty()) {
+        const TreeNode* node = stack.back();
+        stack.pop_back();
+        if (node->left) stack.push_back(node->left);
+        if (node->right) stack.push_back(node->right);
+        bytes += AllocationFootprint(node, sizeof(TreeNode));
+    }
+    return bytes;
+}
+
+void BinaryTree::ResetHighlight(TreeNode* node) {
+    // Fade back to blue instead of instantly resetting
     if (node->searchHighlight || node->insertHighlight) {
         node->searchHighlight = false;
         node->insertHighlight = false;
-        node->fadeTimer = 0.0f; // start fading
+        SetNodeColor(node, BLUE, 0.5f);
     }
-
-    ResetHighlights(node->left);
-    ResetHighlights(node->right);
 }
 
-Color LerpColor(Color from, Color to, float t) {
-    t = fminf(fmaxf(t, 0.0f), 1.0f);
-    return {
-        (unsigned char)(from.r + (to.r - from.r) * t),
-        (unsigned char)(from.g + (to.g - from.g) * t),
-        (unsigned char)(from.b + (to.b - from.b) * t),
-        255
-    };
+void BinaryTree::SetNodeColor(TreeNode* node, Color color, float duration) {
+    // Start from the colour on screen, so an unfinished fade carries on smoothly
+    node->fromColor = LerpColor(node->fromColor, node->targetColor, node->colorMix);
+    node->targetColor = color;
+    node->colorMix = 0.0f;
+    tweens.Add(&node->colorMix, 1.0f, duration, EASE_LINEAR);
 }
 
 
 void BinaryTree::Insert(int value) {
+    // The worker's copy of the tree must not fall out of step with ours
+    if (bulkTotal > 0) {
+        notificationText = "Wait for the bulk insert to finish";
+        notificationTimer = 0.0f;
+        return;
+    }
+
+    // Only the last search path can still be highlighted
+    if (lastSearchHighlight) {
+        lastSearchHighlight->searchHighlight = false;
+        lastSearchHighlight->foundNode = false;
+        SetNodeColor(lastSearchHighlight, BLUE, 0.5f);
+        lastSearchHighlight = nullptr;
+    }
+    Play(InsertSteps(value));
+}
+
+void BinaryTree::InsertImmediate(int value) {
+    TreeNode* newNode = NewNode(TreeNode{ value, nullptr, nullptr,
+        {(float)screenWidth / 2, 0}, {0, 0} });
+    newNode->positioned = false;
+    nodeCount++;
+
+    // A run of immediate inserts is one version
+    if (!history.Editing() || history.EditOp() != TREE_OP_LOAD) history.BeginEdit(TREE_OP_LOAD, 0);
+    TrackNode(newNode, history.Insert(value));
+
     if (!root) {
-        // Insert as root node
-        TreeNode* newNode = new TreeNode{ value, nullptr, nullptr,
-            {(float)screenWidth / 2, 0}, {(float)screenWidth / 2, 150}, true };
-        newNode->positioned = true;
         root = newNode;
-        animatingNodes.push_back(newNode);
         return;
     }
 
-    // Prepare animated insertion path
-    insertValue = value;
-    inserting = true;
-    insertTimer = 0.0f;
-    insertStep = 0;
-    arrowProgress = 0.0f;
-    currentInsertNode = nullptr;
-    nextInsertNode = nullptr;
-    insertPath.clear();
-
-    // Clear previous highlights
-    std::function<void(TreeNode*)> clear = [&](TreeNode* n) {
-        if (!n) return;
-        n->searchHighlight = n->insertHighlight = false;
-        clear(n->left);
-        clear(n->right);
-        };
-    clear(root);
+    TreeNode* parent = root;
+    while (true) {
+        TreeNode*& child = (value < parent->value) ? parent->left : parent->right;
+        if (!child) {
+            child = newNode;
+            return;
+        }
+        parent = child;
+    }
+}
 
-    // Build the actual traversal path for insertion
-    TreeNode* current = root;
+void BinaryTree::Delete(int value) {
+    if (bulkTotal > 0) {
+        notificationText = "Wait for the bulk insert to finish";
+        notificationTimer = 0.0f;
+        return;
+    }
+    FinishSteps();
+    if (!Contains(value)) {
+        notificationText = "Value not found!";
+        notificationTimer = 0.0f;
+        return;
+    }
+
+    const VersionNode* before = history.Root();
+    history.BeginEdit(TREE_OP_DELETE, value);
+    uint32_t removed;
+    history.Remove(value, &removed);
+    history.EndEdit();
+    SyncVisuals(before);
+    notificationText = TextFormat("Deleted node: %d", value);
+    notificationTimer = 0.0f;
+}
+
+
+// -----------------------------------------------------------------------------
+// Versions. Switching is O(1) in the history; the nodes on screen then follow
+// by walking only the parts of the two trees that aren't shared, so stepping
+// one version touches one or two root-to-leaf paths. Nodes that stay keep
+// their position and glide to their new place; nodes that come back grow out
+// of their parent.
+// -----------------------------------------------------------------------------
+void BinaryTree::ShowVersion(size_t version) {
+    // The worker's copy of the tree must not fall out of step with ours
+    if (bulkTotal > 0) return;
+    FinishSteps(); // an insert on its way lands first (and may add a version)
+    version = std::min(version, history.VersionCount() - 1);
+    if (version == history.Current()) return;
+
+    const VersionNode* before = history.Root();
+    history.Select(version);
+    SyncVisuals(before);
+}
+
+void BinaryTree::TrackNode(TreeNode* node, uint32_t id) {
+    node->id = id;
+    if (id >= visualNodes.size()) visualNodes.resize(id + 1, nullptr);
+    visualNodes[id] = node;
+}
+
+TreeNode* BinaryTree::VisualFor(const VersionNode* v) {
+    if (v->id < visualNodes.size() && visualNodes[v->id]) return visualNodes[v->id];
+    TreeNode* node = NewNode(TreeNode{ v->value, nullptr, nullptr,
+        {(float)screenWidth / 2, 0}, {0, 0} });
+    node->positioned = false; // until its parent hands it a start position
+    TrackNode(node, v->id);
+    return node;
+}
+
+void BinaryTree::SyncVisuals(const VersionNode* from) {
+    // Highlights and recorded paths may point at nodes about to go
+    if (lastSearchHighlight) {
+        lastSearchHighlight->searchHighlight = false;
+        lastSearchHighlight->foundNode = false;
+        SetNodeColor(lastSearchHighlight, BLUE, 0.5f);
+        lastSearchHighlight = nullptr;
+    }
+    batchPaths.clear();
+    batchOffsets.clear();
+    batchResults.clear();
+    cacheNodes.clear();
+
+    std::vector<const VersionNode*> leaving, entering;
+    TreeHistory::Diff(from, history.Root(), leaving, entering);
+
+    // Relink every node that changed, parents first
+    std::unordered_set<uint32_t> stays;
+    for (const VersionNode* v : entering) {
+        TreeNode* node = VisualFor(v);
+        node->value = v->value;
+        stays.insert(v->id);
+        TreeNode* children[2] = { v->left ? VisualFor(v->left) : nullptr, v->right ? VisualFor(v->right) : nullptr };
+        for (TreeNode* child : children) {
+            if (child && !child->positioned) {
+                child->position = node->position;
+                child->positioned = true;
+            }
+        }
+        node->left = children[0];
+        node->right = children[1];
+    }
+
+    // Nodes that left: their tweens point into them
+    for (const VersionNode* v : leaving) {
+        if (stays.count(v->id)) continue;
+        TreeNode* node = visualNodes[v->id];
+        tweens.CancelRange(node, sizeof(TreeNode));
+        FreeNode(node);
+        visualNodes[v->id] = nullptr;
+    }
+
+    root = history.Root() ? visualNodes[history.Root()->id] : nullptr;
+    nodeCount = history.Version(history.Current()).nodeCount;
+    Relayout(GetJobSystem());
+    cacheView.Invalidate();
+    memoryView.Invalidate();
+}
+
+bool BinaryTree::Contains(int value, int* pathLength) const {
+    int visited = 0;
+    const TreeNode* current = root;
     while (current) {
-        insertPath.push_back(current);
-        if (value < current->value)
-            current = current->left;
-        else
-            current = current->right;
+        visited++;
+        if (value == current->value) break;
+        current = (value < current->value) ? current->left : current->right;
+    }
+    if (pathLength) *pathLength = visited;
+    return current != nullptr;
+}
+
+void BinaryTree::SearchBatch(const int* keys, size_t count, BatchSearchResult* results) const {
+    // Each lane walks one key down the tree. All lanes advance one level per
+    // round and prefetch the child they will read next round, so the cache
+    // misses of up to batchLanes descents overlap instead of running back to back.
+    struct Lane {
+        const TreeNode* node;
+        size_t key;
+        int depth;
+    };
+    Lane lanes[batchLanes];
+
+    size_t next = 0;
+    int active = 0;
+    while (active < batchLanes && next < count) {
+        lanes[active++] = { root, next++, 0 };
     }
 
-    // Highlight start node
-    if (!insertPath.empty())
-        insertPath.front()->insertHighlight = true;
+    while (active > 0) {
+        for (int i = 0; i < active;) {
+            Lane& lane = lanes[i];
+            const TreeNode* node = lane.node;
+            int key = keys[lane.key];
+
+            if (node && node->value != key) {
+                lane.node = (key < node->value) ? node->left : node->right;
+                lane.depth++;
+                Prefetch(lane.node);
+                i++;
+                continue;
+            }
+
+            // Lane finished: record it, then refill with the next key or retire it
+            results[lane.key] = { node != nullptr, lane.depth + (node ? 1 : 0) };
+            if (next < count) {
+                lane = { root, next++, 0 };
+                i++;
+            }
+            else {
+                lane = lanes[--active];
+            }
+        }
+    }
 }
 
 
@@ -90,7 +375,6 @@ void BinaryTree::ComputeNodePositions(TreeNode* node, int depth, int xMin, int x
     // Only set target position if node hasnt been positioned yet
     if (!node->positioned) {
         node->targetPosition = { (xMin + xMax) / 2.0f, 150 + depth * 100.0f };
-        node->animating = true;
         node->positioned = true;
     }
 
@@ -100,148 +384,138 @@ void BinaryTree::ComputeNodePositions(TreeNode* node, int depth, int xMin, int x
 }
 
 
-void BinaryTree::UpdateNode(TreeNode* node, float dt) {
-    if (!node || !node->animating) return;
-
-    // Linear interpolation factor
-    float t = 5.0f * dt; // 5 = speed multiplier
-    if (t > 1.0f) t = 1.0f;
-
-    // Interpolate toward target
-    node->position.x = node->position.x + (node->targetPosition.x - node->position.x) * t;
-    node->position.y = node->position.y + (node->targetPosition.y - node->position.y) * t;
-
-    // If node is very close to target, snap to target and stop animating
-    if (fabs(node->position.x - node->targetPosition.x) < 0.5f &&
-        fabs(node->position.y - node->targetPosition.y) < 0.5f) {
-        node->position = node->targetPosition;
-        node->animating = false;
+// -----------------------------------------------------------------------------
+// Full relayout: ComputeNodePositions' recursion in two passes. The first
+// measures subtree sizes bottom-up; the second hands each subtree its
+// horizontal range (or first in-order column) top-down. Sibling subtrees are
+// independent in both passes, so they run as fork-join jobs.
+// -----------------------------------------------------------------------------
+void BinaryTree::Relayout(JobSystem& jobs) {
+    ProfileScope scope(PHASE_LAYOUT);
+    if (!root) return;
+
+    int count = MeasureSubtree(root, 0, jobs);
+    if (count > 1) {
+        layoutLeft = 50.0f;
+        layoutColumn = (screenWidth - 2 * layoutLeft) / (count - 1);
     }
-}
+    else {
+        layoutLeft = screenWidth / 2.0f;
+        layoutColumn = 0.0f;
+    }
+    PlaceSubtree(root, 0, 0.0f, (float)screenWidth, 0, jobs);
 
+    // Only on-screen nodes glide to their new place (see PlaceSubtree)
+    AnimateToTargets(root);
+}
 
+void BinaryTree::SetLayout(TreeLayout newLayout) {
+    layout = newLayout;
+    Relayout(GetJobSystem());
+}
 
-void BinaryTree::UpdateAnimations() {
-    float dt = GetFrameTime();
+int BinaryTree::MeasureSubtree(TreeNode* node, int depth, JobSystem& jobs) {
+    if (!node) return 0;
 
-    // Animate node insertions
-    for (auto node : animatingNodes) {
-        UpdateNode(node, dt);
+    int leftSize = 0, rightSize = 0;
+    if (depth < layoutForkDepth) {
+        jobs.ParallelInvoke([&] { leftSize = MeasureSubtree(node->left, depth + 1, jobs); },
+            [&] { rightSize = MeasureSubtree(node->right, depth + 1, jobs); });
     }
+    else {
+        leftSize = MeasureSubtree(node->left, depth + 1, jobs);
+        rightSize = MeasureSubtree(node->right, depth + 1, jobs);
+    }
+    node->subtreeSize = leftSize + rightSize + 1;
+    return node->subtreeSize;
+}
 
-    // Remove finished animations
-    animatingNodes.erase(
-        std::remove_if(animatingNodes.begin(), animatingNodes.end(),
-            [](TreeNode* n) { return !n->animating; }),
-        animatingNodes.end()
-    );
-
-    // Handle search animation
-    if (searching && !searchQueue.empty()) {
-        searchTimer += dt;
-        if (searchTimer >= searchDelay) {
-            searchTimer = 0.0f;
-
-            TreeNode* node = searchQueue.front();
-            searchQueue.pop();
+void BinaryTree::PlaceSubtree(TreeNode* node, int depth, float xMin, float xMax, int firstColumn, JobSystem& jobs) {
+    int leftSize = node->left ? node->left->subtreeSize : 0;
+    float mid = (xMin + xMax) / 2;
 
-            node->searchHighlight = true;
+    // Compact: the subtree owns columns [firstColumn, firstColumn + subtreeSize)
+    float x = (layout == TREE_LAYOUT_COMPACT) ? layoutLeft + (firstColumn + leftSize) * layoutColumn : mid;
+    node->targetPosition = { x, 150 + depth * 100.0f };
+    node->positioned = true;
 
-            // Unhighlight others
-            std::queue<TreeNode*> tempQueue = searchQueue;
-            while (!tempQueue.empty()) {
-                TreeNode* n = tempQueue.front();
-                tempQueue.pop();
-                n->searchHighlight = false;
-            }
+    // Off-screen nodes jump straight there; AnimateToTargets tweens the rest
+    // afterwards, since the tween engine is only touched on the main thread
+    if (node->targetPosition.y >= screenHeight + 25) node->position = node->targetPosition;
 
-            if (node->value == searchTarget || searchQueue.empty()) {
-                searching = false; // search done
-            }
-        }
+    auto placeLeft = [&] {
+        if (node->left) PlaceSubtree(node->left, depth + 1, xMin, mid, firstColumn, jobs);
+    };
+    auto placeRight = [&] {
+        if (node->right) PlaceSubtree(node->right, depth + 1, mid, xMax, firstColumn + leftSize + 1, jobs);
+    };
+    if (node->subtreeSize > layoutForkSize) {
+        jobs.ParallelInvoke(placeLeft, placeRight);
     }
-
-    // After handling searchQueue
-    if (!searching && nodeToHighlight) {
-        nodeToHighlight->foundNode = true; // mark green
-        notificationText = TextFormat("Found node: %d", nodeToHighlight->value);
-        notificationTimer = 0.0f;
-        nodeToHighlight = nullptr; // reset so it doesnt re-trigger
+    else {
+        placeLeft();
+        placeRight();
     }
+}
 
+void BinaryTree::AnimateToTargets(TreeNode* node) {
+    // Targets only get deeper further down, so stop below the screen
+    if (!node || node->targetPosition.y >= screenHeight + 25) return;
+    if (node->position.x != node->targetPosition.x || node->position.y != node->targetPosition.y)
+        AnimatePosition(node);
+    AnimateToTargets(node->left);
+    AnimateToTargets(node->right);
+}
 
-    // Handle insertion path animation with arrows
-    // ---- Insertion traversal animation ----
-    if (inserting && !insertPath.empty()) {
-        float dt = GetFrameTime();
-        insertTimer += dt;
+void BinaryTree::AnimatePosition(TreeNode* node) {
+    // A node's depth (and so its target's y) never changes, so a node headed
+    // below the screen never has a tween for a relayout to fight with
+    if (node->targetPosition.y >= screenHeight + 25) {
+        node->position = node->targetPosition;
+        return;
+    }
+    tweens.Add(&node->position.x, node->targetPosition.x, moveDuration, EASE_OUT_CUBIC);
+    tweens.Add(&node->position.y, node->targetPosition.y, moveDuration, EASE_OUT_CUBIC);
+}
 
-        // If we havent reached the end of the path
-        if (insertStep < (int)insertPath.size() - 1) {
-            currentInsertNode = insertPath[insertStep];
-            nextInsertNode = insertPath[insertStep + 1];
-            currentInsertNode->insertHighlight = true;
 
-            arrowProgress += dt * 1.5f; // control arrow speed
-            if (arrowProgress >= 1.0f) {
-                arrowProgress = 0.0f;
-                insertStep++;
-            }
-        }
-        else if (insertStep == (int)insertPath.size() - 1) {
-            // Final step  perform actual insertion
-            TreeNode* parent = insertPath.back();
-            TreeNode* newNode = new TreeNode{ insertValue, nullptr, nullptr,
-                { parent->position.x, parent->position.y },
-                { 0,0 }, true };
-            newNode->positioned = false;
-
-            if (insertValue < parent->value)
-                parent->left = newNode;
-            else
-                parent->right = newNode;
-
-            ComputeNodePositions(root, 0, 0, screenWidth);
-            animatingNodes.push_back(newNode);
-
-            // Reset
-            inserting = false;
-            insertStep = 0;
-            currentInsertNode = nullptr;
-            nextInsertNode = nullptr;
-            arrowProgress = 0.0f;
-            insertPath.clear();
-
-            // Reset node colors back to blue
-            ResetHighlights(root);
 
-        }
-    }
-
-    // --- Fade highlighted nodes back to blue gradually ---
-    std::function<void(TreeNode*)> fadeNodes = [&](TreeNode* node) {
-        if (!node) return;
+void BinaryTree::UpdateAnimations() {
+    ProfileScope scope(PHASE_ANIMATION_TICK);
+    float dt = FrameTime();
+
+    // Node movement and colour fades
+    tweens.Tick(dt);
+
+    // Play the current algorithm's steps
+    UpdateSteps(dt);
+
+    // Apply what the model worker has produced, a bounded amount per frame
+    if (bulkTotal > 0) {
+        ProfileScope model(PHASE_MODEL_UPDATE);
+        worker.Drain(drainBudget, [this](const VisEvent& e) { ApplyModelEvent(e); });
+        if (!worker.Busy()) {
+            notificationText = bulkCapped
+                ? TextFormat("Bulk insert: %d nodes added (capped at %d in the tree)", bulkApplied, maxBulkNodes)
+                : TextFormat("Bulk insert: %d nodes added", bulkApplied);
+            notificationTimer = 0.0f;
+            bulkTotal = 0;
+            history.EndEdit();
+            nodeById.clear();
+            nodeById.shrink_to_fit();
 
-        if (!node->searchHighlight && !node->insertHighlight && !node->foundNode && node->fadeTimer < 1.0f) {
-            node->fadeTimer += dt * 2.0f; // fade duration
-            Color target = BLUE;
-            Color start = node->currentColor;
-            node->currentColor = LerpColor(start, target, node->fadeTimer);
+            // Bulk nodes were placed midpoint-style as they arrived
+            if (layout == TREE_LAYOUT_COMPACT) Relayout(GetJobSystem());
         }
-        else if (node->foundNode) {
-            node->currentColor = GREEN; // Highlight found node
-        }
-        else if (node->searchHighlight)
-            node->currentColor = RED;
-        else if (node->insertHighlight)
-            node->currentColor = GOLD;
-        else
-            node->currentColor = BLUE;
+    }
 
-        fadeNodes(node->left);
-        fadeNodes(node->right);
-        };
-    fadeNodes(root);
+    // Drop the finished batch paths once the summary has been shown
+    bool batchRunning = playing && step.type == STEP_BATCH_ROUND;
+    if (!batchRunning && !batchOffsets.empty() && notificationText.empty()) {
+        batchPaths.clear();
+        batchOffsets.clear();
+        batchResults.clear();
+    }
 
     // --- Update notification timer ---
     if (!notificationText.empty()) {
@@ -249,61 +523,17 @@ void BinaryTree::UpdateAnimations() {
         if (notificationTimer >= notificationDuration) {
             notificationText.clear();
         }
-
-        if (!searching && nodeToHighlight) {
-            nodeToHighlight->foundNode = true;
-            notificationText = TextFormat("Found node: %d", nodeToHighlight->value);
-            notificationTimer = 0.0f;
-
-            // Schedule fade back to blue
-            std::function<void(TreeNode*)> resetFound = [&](TreeNode* n) {
-                if (!n) return;
-                n->foundNode = false; // will gradually fade to blue
-                resetFound(n->left);
-                resetFound(n->right);
-                };
-            resetFound(nodeToHighlight);
-
-            nodeToHighlight = nullptr;
-        }
     }
-
-    std::function<void(TreeNode*, float)> updateColors = [&](TreeNode* node, float dt) {
-        if (!node) return;
-
-        // Set target color
-        if (node->searchHighlight) node->targetColor = RED;
-        else if (node->foundNode) node->targetColor = GREEN;
-        else if (node->fading) node->targetColor = BLUE; // fade back to blue
-        else node->targetColor = BLUE;
-
-        // Linear interpolation toward target
-        float t = 3.0f * dt; // speed factor
-        node->currentColor.r += (node->targetColor.r - node->currentColor.r) * t;
-        node->currentColor.g += (node->targetColor.g - node->currentColor.g) * t;
-        node->currentColor.b += (node->targetColor.b - node->currentColor.b) * t;
-        node->currentColor.a += (node->targetColor.a - node->currentColor.a) * t;
-
-        // If fading finished, stop fading
-        if (node->fading &&
-            fabs(node->currentColor.r - node->targetColor.r) < 1.0f &&
-            fabs(node->currentColor.g - node->targetColor.g) < 1.0f &&
-            fabs(node->currentColor.b - node->targetColor.b) < 1.0f) {
-            node->fading = false;
-            node->foundNode = false;
-        }
-
-        updateColors(node->left, dt);
-        updateColors(node->right, dt);
-        };
-
-    updateColors(root, dt);
 }
 
 
 void BinaryTree::DrawNode(TreeNode* node) {
     if (!node) return;
 
+    // Children are drawn below their parent, so nothing under a node that is
+    // already off the bottom of the screen can be visible
+    if (node->position.y > screenHeight + 25) return;
+
     if (node->left) {
         DrawLineV(node->position, node->left->position, BLACK);
         DrawNode(node->left);
@@ -313,7 +543,7 @@ void BinaryTree::DrawNode(TreeNode* node) {
         DrawNode(node->right);
     }
 
-    Color nodeColor = node->currentColor;
+    Color nodeColor = LerpColor(node->fromColor, node->targetColor, node->colorMix);
     DrawCircleV(node->position, 25, nodeColor);
 
     int textWidth = MeasureText(TextFormat("%d", node->value), 20);
@@ -321,12 +551,37 @@ void BinaryTree::DrawNode(TreeNode* node) {
 }
 
 
+void BinaryTree::DrawBatchPaths() {
+    static const Color laneColors[] = { RED, ORANGE, PURPLE, LIME, MAGENTA, SKYBLUE, BROWN, DARKGREEN };
+    const int colorCount = sizeof(laneColors) / sizeof(laneColors[0]);
+
+    for (size_t k = 0; k + 1 < batchOffsets.size(); k++) {
+        Color color = laneColors[k % colorCount];
+        size_t begin = batchOffsets[k];
+        size_t end = std::min(batchOffsets[k + 1], begin + batchStep + 1);
+        if (begin == end) continue;
+
+        for (size_t i = begin + 1; i < end; i++)
+            DrawLineEx(batchPaths[i - 1]->position, batchPaths[i]->position, 4, color);
+
+        // Ring around the node this path has reached; offset per lane so overlapping paths stay visible
+        DrawRing(batchPaths[end - 1]->position, 27.0f + 3 * (k % 4), 30.0f + 3 * (k % 4), 0, 360, 24, color);
+    }
+}
+
 void BinaryTree::Draw() {
+    ProfileScope scope(PHASE_DRAW);
     DrawNode(root);
+    if (cacheView.Active()) {
+        for (size_t i = 0; i < cacheNodes.size(); i++)
+            if (cacheNodes[i]->position.y <= screenHeight + 25)
+                cacheView.DrawMarker(cacheNodes[i]->position, 27.0f, i);
+    }
+    DrawBatchPaths();
     // Draw animated arrow between nodes during insertion
-    if (inserting && currentInsertNode && nextInsertNode) {
-        Vector2 start = currentInsertNode->position;
-        Vector2 end = nextInsertNode->position;
+    if (playing && step.type == STEP_DESCEND) {
+        Vector2 start = step.node->position;
+        Vector2 end = step.next->position;
 
         Vector2 tip = {
             start.x + (end.x - start.x) * arrowProgress,
@@ -346,53 +601,363 @@ void BinaryTree::Draw() {
 }
 
 void BinaryTree::Search(int value) {
-    searchTarget = value;
-    searching = true;
-    searchTimer = 0.0f;
+    // Clear previous highlights (only the previous search path can hold them)
+    if (lastSearchHighlight) {
+        lastSearchHighlight->searchHighlight = false;
+        lastSearchHighlight->foundNode = false;
+        SetNodeColor(lastSearchHighlight, BLUE, 0.5f);
+        lastSearchHighlight = nullptr;
+    }
+    Play(SearchSteps(value));
+}
 
-    // Clear previous highlights
-    std::function<void(TreeNode*)> clearHighlights = [&](TreeNode* node) {
-        if (!node) return;
-        node->searchHighlight = false;
-        node->insertHighlight = false;
-        node->foundNode = false; // reset
-        clearHighlights(node->left);
-        clearHighlights(node->right);
-    };
-    clearHighlights(root);
+void BinaryTree::StartBatchSearch(const std::string& keyList) {
+    // Keys are separated by anything that isn't part of a number, e.g. "5, 12 30".
+    // A number too big for an int is dropped; the rest are still searched.
+    std::vector<int> keys;
+    size_t i = 0;
+    while (i < keyList.size()) {
+        size_t start = i;
+        if (keyList[i] == '-') i++;
+        size_t digits = i;
+        while (i < keyList.size() && isdigit((unsigned char)keyList[i])) i++;
+        if (i > digits) {
+            int key;
+            if (std::from_chars(keyList.data() + start, keyList.data() + i, key).ec == std::errc())
+                keys.push_back(key);
+        }
+        else i = start + 1;
+    }
+    if (keys.empty()) return;
+
+    Play(BatchSearchSteps(std::move(keys)));
+}
+
+
+// -----------------------------------------------------------------------------
+// Step coroutines. Each reads like the plain algorithm; the co_yields mark
+// where the animation pauses. Nothing runs ahead of what is on screen, so a
+// tree change can't invalidate a recorded path.
+// -----------------------------------------------------------------------------
+Generator<TreeStep> BinaryTree::InsertSteps(int value) {
+    TreeNode* parent = nullptr;
+    for (TreeNode* current = root; current;) {
+        TreeNode* next = (value < current->value) ? current->left : current->right;
+        if (next) co_yield TreeStep{ STEP_DESCEND, current, next };
+        parent = current;
+        current = next;
+    }
+
+    TreeNode* newNode;
+    if (!parent) {
+        // Insert as root node
+        newNode = NewNode(TreeNode{ value, nullptr, nullptr,
+            {(float)screenWidth / 2, 0}, {(float)screenWidth / 2, 150} });
+        newNode->positioned = true;
+        root = newNode;
+    }
+    else {
+        // New node grows out of its parent
+        newNode = NewNode(TreeNode{ value, nullptr, nullptr,
+            { parent->position.x, parent->position.y },
+            { 0,0 } });
+        newNode->positioned = false;
+        if (value < parent->value)
+            parent->left = newNode;
+        else
+            parent->right = newNode;
+    }
+    nodeCount++;
+    history.BeginEdit(TREE_OP_INSERT, value);
+    TrackNode(newNode, history.Insert(value));
+    history.EndEdit();
+    co_yield TreeStep{ STEP_ATTACH, newNode, parent };
+}
 
-    // Prepare search queue
-    searchQueue = std::queue<TreeNode*>();
+Generator<TreeStep> BinaryTree::SearchSteps(int value) {
     TreeNode* current = root;
-    TreeNode* found = nullptr;
     while (current) {
-        searchQueue.push(current);
+        co_yield TreeStep{ STEP_VISIT, current };
         if (value == current->value) {
-            found = current; // save found node
-            nodeToHighlight = current;
-            break;
+            co_yield TreeStep{ STEP_FOUND, current };
+            co_return;
         }
         current = (value < current->value) ? current->left : current->right;
     }
+    co_yield TreeStep{ STEP_NOT_FOUND };
+}
 
-    // Store found node for highlighting
-    if (found) {
-        nodeToHighlight->foundNode = true;
-        nodeToHighlight->fading = true; // enable gradual fade
-        notificationText = TextFormat("Found node: %d", nodeToHighlight->value);
-        notificationTimer = 0.0f;
-        nodeToHighlight = nullptr;
+Generator<TreeStep> BinaryTree::BatchSearchSteps(std::vector<int> keys) {
+    batchResults.resize(keys.size());
+    SearchBatch(keys.data(), keys.size(), batchResults.data());
+
+    // Record every path for the animation
+    batchPaths.clear();
+    batchOffsets.clear();
+    size_t longest = 0;
+    for (int key : keys) {
+        batchOffsets.push_back(batchPaths.size());
+        TreeNode* current = root;
+        while (current) {
+            batchPaths.push_back(current);
+            if (key == current->value) break;
+            current = (key < current->value) ? current->left : current->right;
+        }
+        longest = std::max(longest, batchPaths.size() - batchOffsets.back());
     }
-    else {
-        nodeToHighlight = nullptr;
+    batchOffsets.push_back(batchPaths.size());
+    notificationText.clear();
+
+    // Every path advances one node per round
+    for (size_t round = 0; round < longest; round++)
+        co_yield TreeStep{ STEP_BATCH_ROUND, nullptr, nullptr, (int)round };
+    co_yield TreeStep{ STEP_BATCH_DONE };
+}
+
+
+// -----------------------------------------------------------------------------
+// Animator: pulls steps from the running coroutine and shows them
+// -----------------------------------------------------------------------------
+void BinaryTree::Play(Generator<TreeStep> algorithm) {
+    // A new request finishes the running algorithm instead of dropping it
+    FinishSteps();
+    steps = std::move(algorithm);
+    playing = true;
+    AdvanceStep();
+}
+
+bool BinaryTree::AdvanceStep() {
+    stepTimer = 0.0f;
+    arrowProgress = 0.0f;
+    if (!steps.Next()) {
+        playing = false;
+        step = {};
+        steps = Generator<TreeStep>(); // frees the finished coroutine
+        return false;
+    }
+    step = steps.Value();
+    ApplyStep(step);
+    return true;
+}
+
+float BinaryTree::StepDuration(const TreeStep& s) const {
+    switch (s.type) {
+    case STEP_VISIT:
+    case STEP_BATCH_ROUND: return searchDelay;
+    case STEP_DESCEND: return 1.0f / arrowSpeed;
+    default: return 0.0f;
+    }
+}
+
+void BinaryTree::ApplyStep(const TreeStep& s) {
+    switch (s.type) {
+    case STEP_VISIT:
+        // Move the highlight one node down the path
+        if (lastSearchHighlight) {
+            lastSearchHighlight->searchHighlight = false;
+            SetNodeColor(lastSearchHighlight, BLUE, 0.5f);
+        }
+        s.node->searchHighlight = true;
+        SetNodeColor(s.node, RED, 0.15f);
+        lastSearchHighlight = s.node;
+        break;
+
+    case STEP_FOUND:
+        s.node->foundNode = true;
+        SetNodeColor(s.node, GREEN, 0.15f); // until the next search or insert
+        notificationText = TextFormat("Found node: %d", s.node->value);
+        notificationTimer = 0.0f;
+        break;
+
+    case STEP_NOT_FOUND:
         notificationText = "Value not found!";
         notificationTimer = 0.0f;
+        break;
+
+    case STEP_DESCEND:
+        s.node->insertHighlight = true;
+        SetNodeColor(s.node, GOLD, 0.15f);
+        insertPath.push_back(s.node);
+        break;
+
+    case STEP_ATTACH:
+        if (layout == TREE_LAYOUT_COMPACT) {
+            // Every node right of the new one moves over a column
+            Relayout(GetJobSystem());
+        }
+        else {
+            // Only the new node needs a place; a parent not placed yet means
+            // unplaced nodes elsewhere too, which the full pass catches
+            ProfileScope layoutScope(PHASE_LAYOUT);
+            if (s.next && s.next->positioned) {
+                PlaceChild(s.next, s.node, s.node == s.next->right);
+                s.node->positioned = true;
+            }
+            else {
+                ComputeNodePositions(root, 0, 0, screenWidth);
+            }
+            AnimatePosition(s.node);
+        }
+
+        // Reset node colors back to blue: only the nodes this insert and the
+        // last search lit, not the whole tree
+        for (TreeNode* node : insertPath) ResetHighlight(node);
+        insertPath.clear();
+        if (lastSearchHighlight) ResetHighlight(lastSearchHighlight);
+        break;
+
+    case STEP_BATCH_ROUND:
+        batchStep = s.round;
+        break;
+
+    case STEP_BATCH_DONE: {
+        int found = 0;
+        for (const BatchSearchResult& r : batchResults)
+            if (r.found) found++;
+        notificationText = TextFormat("Batch: found %d of %d", found, (int)batchResults.size());
+        notificationTimer = 0.0f;
+        break;
+    }
     }
+}
+
+void BinaryTree::UpdateSteps(float dt) {
+    ProfileScope scope(PHASE_MODEL_UPDATE);
+    // Zero-length steps (found, attach, ...) don't hold up the next one
+    stepTimer += dt;
+    while (playing) {
+        float duration = StepDuration(step);
+        if (step.type == STEP_DESCEND)
+            arrowProgress = fminf(stepTimer / duration, 1.0f);
+        if (stepTimer < duration) return;
+        AdvanceStep();
+    }
+}
 
+void BinaryTree::FinishSteps() {
+    ProfileScope scope(PHASE_MODEL_UPDATE);
+    while (playing) AdvanceStep();
 }
 
 
+// -----------------------------------------------------------------------------
+// Bulk insertion on the model worker. The worker descends its own index-based
+// copy of the tree at full speed and publishes node-created / link-changed
+// events; UpdateAnimations applies a bounded number of them per frame.
+// -----------------------------------------------------------------------------
+void BinaryTree::StartBulkInsert(int count) {
+    if (count <= 0 || bulkTotal > 0) return;
+    ProfileScope scope(PHASE_MODEL_UPDATE);
+    FinishSteps(); // an animated insert must land before the snapshot
+
+    int room = nodeCount < (size_t)maxBulkNodes ? maxBulkNodes - (int)nodeCount : 0;
+    bulkCapped = count > room;
+    if (bulkCapped) {
+        count = room;
+        notificationText = TextFormat("Bulk insert capped at %d nodes in the tree", maxBulkNodes);
+        notificationTimer = 0.0f;
+        if (count == 0) return;
+    }
+
+    // Snapshot the tree for the worker; node i has id i in both copies
+    struct ModelNode { int value; int left; int right; };
+    std::vector<ModelNode> model;
+    nodeById.clear();
+    if (root) nodeById.push_back(root);
+    for (size_t i = 0; i < nodeById.size(); i++) {
+        TreeNode* node = nodeById[i];
+        ModelNode m = { node->value, -1, -1 };
+        if (node->left) {
+            m.left = (int)nodeById.size();
+            nodeById.push_back(node->left);
+        }
+        if (node->right) {
+            m.right = (int)nodeById.size();
+            nodeById.push_back(node->right);
+        }
+        model.push_back(m);
+    }
+
+    bulkTotal = count;
+    bulkApplied = 0;
+    history.BeginEdit(TREE_OP_LOAD, count);
+    unsigned seed = std::random_device{}();
+    worker.Run([model = std::move(model), count, seed](ModelWorker& w) mutable {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> dist(0, 999999);
+        model.reserve(model.size() + count);
+        if (!w.Publish({ VIS_BEGIN, count * 2, 0, 0 })) return;
+
+        for (int i = 0; i < count; i++) {
+            int value = dist(rng);
+            int id = (int)model.size();
+            model.push_back({ value, -1, -1 });
+            if (!w.Publish({ VIS_NODE_CREATED, id, value, 0 })) return;
+
+            // Same descent as InsertImmediate (duplicates go right)
+            int parent = -1, side = 0;
+            if (id > 0) {
+                parent = 0;
+                while (true) {
+                    side = value < model[parent].value ? 0 : 1;
+                    int& child = side ? model[parent].right : model[parent].left;
+                    if (child < 0) {
+                        child = id;
+                        break;
+                    }
+                    parent = child;
+                }
+            }
+            if (!w.Publish({ VIS_LINK_CHANGED, parent, id, side })) return;
+        }
+    });
+}
+
+void BinaryTree::ApplyModelEvent(const VisEvent& e) {
+    if (e.type == VIS_NODE_CREATED) {
+        TreeNode* node = NewNode(TreeNode{ e.b, nullptr, nullptr, { 0, 0 }, { 0, 0 } });
+        node->positioned = true; // placed when it is linked
+        nodeById.push_back(node); // ids are handed out in order
+        unlinkedNode = node;
+    }
+    else if (e.type == VIS_LINK_CHANGED) {
+        TreeNode* child = nodeById[e.b];
+        if (e.a < 0) {
+            root = child;
+            child->position = { (float)screenWidth / 2, 0 };
+            child->targetPosition = { (float)screenWidth / 2, 150 };
+        }
+        else {
+            TreeNode* parent = nodeById[e.a];
+            if (e.c) parent->right = child;
+            else parent->left = child;
+            PlaceChild(parent, child, e.c != 0);
+        }
+        unlinkedNode = nullptr;
+        TrackNode(child, history.Insert(child->value));
+        nodeCount++;
+        bulkApplied++;
+
+        // Only nodes that land on screen are worth animating
+        AnimatePosition(child);
+    }
+}
+
+void BinaryTree::PlaceChild(TreeNode* parent, TreeNode* child, bool right) {
+    // Same midpoint layout as ComputeNodePositions without walking the tree: a
+    // node at depth d owns screenWidth / 2^d pixels and its children sit a
+    // quarter of that to either side
+    int depth = (int)((parent->targetPosition.y - 150) / 100.0f + 0.5f);
+    float offset = ldexpf((float)screenWidth, -(depth + 2));
+    child->targetPosition = { parent->targetPosition.x + (right ? offset : -offset),
+        parent->targetPosition.y + 100 };
+    child->position = parent->position;
+}
+
+
+
 void BinaryTree::HandleInput() {
+    ProfileScope scope(PHASE_INPUT);
     Vector2 mousePos = GetMousePosition();
 
     // Activate input boxes on click
@@ -450,6 +1015,141 @@ void BinaryTree::HandleInput() {
             searchValue.clear();
         }
     }
+
+    if (CheckCollisionPointRec(mousePos, batchBtn) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        if (!searchValue.empty()) {
+            StartBatchSearch(searchValue);
+            searchValue.clear();
+        }
+    }
+
+    if (CheckCollisionPointRec(mousePos, skipBtn) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        FinishSteps();
+    }
+
+    if (CheckCollisionPointRec(mousePos, deleteBtn) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        if (!inputValue.empty()) {
+            Delete(std::stoi(inputValue));
+            inputValue.clear();
+        }
+    }
+
+    // Undo/redo (also Ctrl+Z / Ctrl+Y) and dragging along the timeline
+    bool ctrl = IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL);
+    if ((CheckCollisionPointRec(mousePos, undoBtn) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
+        || (ctrl && IsKeyPressed(KEY_Z))) {
+        if (history.Current() > 0) ShowVersion(history.Current() - 1);
+    }
+    if ((CheckCollisionPointRec(mousePos, redoBtn) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
+        || (ctrl && IsKeyPressed(KEY_Y))) {
+        ShowVersion(history.Current() + 1);
+    }
+    Rectangle timelineHit = { timeline.x - 10, timeline.y - 10, timeline.width + 20, timeline.height + 20 };
+    if (CheckCollisionPointRec(mousePos, timelineHit) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) scrubbing = true;
+    if (!IsMouseButtonDown(MOUSE_LEFT_BUTTON)) scrubbing = false;
+    if (scrubbing && history.VersionCount() > 1) {
+        float t = std::clamp((mousePos.x - timeline.x) / timeline.width, 0.0f, 1.0f);
+        ShowVersion((size_t)(t * (history.VersionCount() - 1) + 0.5f));
+    }
+
+    if (CheckCollisionPointRec(mousePos, layoutBtn) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        SetLayout(layout == TREE_LAYOUT_COMPACT ? TREE_LAYOUT_MIDPOINT : TREE_LAYOUT_COMPACT);
+    }
+
+    // Bulk insert: the insert box holds how many random keys to add. A count
+    // too big for an int asks for the most; StartBulkInsert caps it.
+    if (CheckCollisionPointRec(mousePos, bulkBtn) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        if (!inputValue.empty()) {
+            int count = 0;
+            std::errc error = std::from_chars(inputValue.data(), inputValue.data() + inputValue.size(), count).ec;
+            if (error == std::errc::result_out_of_range) count = inputValue[0] == '-' ? 0 : INT_MAX;
+            StartBulkInsert(count);
+            inputValue.clear();
+        }
+    }
+
+    // Cache view: search/insert use the typed value; an empty box traces the
+    // rightmost path. Held back while a bulk insert is still growing the tree.
+    cacheView.HandleInput();
+    const std::string& cacheInput = cacheView.Op() == CACHE_TRACE_SEARCH ? searchValue : inputValue;
+    int cacheKey = cacheInput.empty() ? INT_MAX : atoi(cacheInput.c_str());
+    if (cacheView.Op() == CACHE_TRACE_TRAVERSE) cacheKey = 0;
+    if (bulkTotal == 0 && cacheView.NeedsReplay(cacheKey, nodeCount)) {
+        TraceOperation(cacheView.Op(), cacheKey, cacheView.BeginTrace());
+        cacheView.Replay();
+    }
+
+    // Memory view: the storage switch waits for a running animation to end
+    memoryView.HandleInput();
+    if (memoryView.PoolRequested() != usePool) {
+        SetPooled(memoryView.PoolRequested());
+        if (usePool == memoryView.PoolRequested()) {
+            memoryView.Invalidate();
+            cacheView.Invalidate();
+        }
+    }
+    if (bulkTotal == 0 && memoryView.NeedsRefresh(nodeCount)) {
+        CollectNodes(memoryView.BeginCollect());
+        memoryView.Refresh(sizeof(TreeNode), FootprintBytes());
+    }
+}
+
+void BinaryTree::TraceOperation(CacheTraceOp op, int key, AddressTrace& trace) {
+    // Each visit reads the key and both child pointers at the front of the node
+    const size_t visitBytes = offsetof(TreeNode, right) + sizeof(TreeNode*);
+    cacheNodes.clear();
+
+    if (op == CACHE_TRACE_TRAVERSE) {
+        // In order, with an explicit stack so degenerate trees can't overflow
+        std::vector<TreeNode*> stack;
+        TreeNode* node = root;
+        while (node || !stack.empty()) {
+            while (node) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            node = stack.back();
+            stack.pop_back();
+            RecordAccess(trace, node, visitBytes, (int)cacheNodes.size());
+            cacheNodes.push_back(node);
+            node = node->right;
+        }
+        return;
+    }
+
+    // Search and insert follow the same path; insert stops at the parent
+    for (TreeNode* node = root; node;) {
+        RecordAccess(trace, node, visitBytes, (int)cacheNodes.size());
+        cacheNodes.push_back(node);
+        if (op == CACHE_TRACE_SEARCH && node->value == key) break;
+        node = key < node->value ? node->left : node->right;
+    }
+}
+
+void BinaryTree::DrawTimeline() {
+    size_t count = history.VersionCount();
+    size_t current = history.Current();
+    float step = count > 1 ? timeline.width / (count - 1) : 0.0f;
+
+    DrawRectangleRec(timeline, Fade(LIGHTGRAY, 0.6f));
+    DrawRectangleLinesEx(timeline, 1, GRAY);
+    DrawRectangle((int)timeline.x, (int)timeline.y, (int)(current * step), (int)timeline.height, Fade(SKYBLUE, 0.8f));
+    if (step >= 4.0f) {
+        for (size_t i = 0; i < count; i++)
+            DrawLineV({ timeline.x + i * step, timeline.y }, { timeline.x + i * step, timeline.y + timeline.height }, GRAY);
+    }
+    DrawCircleV({ timeline.x + current * step, timeline.y + timeline.height / 2 }, 9, DARKBLUE);
+
+    // What made this version, and what sharing saves over a copy per version
+    const TreeVersion& v = history.Version(current);
+    const char* what = "empty tree";
+    if (v.op == TREE_OP_INSERT) what = TextFormat("insert %d", v.value);
+    else if (v.op == TREE_OP_DELETE) what = TextFormat("delete %d", v.value);
+    else if (v.op == TREE_OP_LOAD) what = TextFormat("load %d keys", (int)(v.nodeCount - history.Version(current - 1).nodeCount));
+    DrawText(TextFormat("Version %d / %d: %s, %d nodes   |   all versions: %d nodes stored (%d KB), %d as full copies",
+        (int)current, (int)count - 1, what, (int)v.nodeCount, (int)history.StoredNodes(),
+        (int)(history.FootprintBytes() / 1024), (int)history.SnapshotNodes()),
+        (int)timeline.x, (int)(timeline.y + timeline.height + 10), 20, DARKGRAY);
 }
 
 void BinaryTree::DrawUI() {
@@ -474,6 +1174,43 @@ void BinaryTree::DrawUI() {
     DrawRectangleLinesEx(searchBtn, 2, DARKGRAY);
     DrawText("Search", searchBtn.x + 35, searchBtn.y + 5, 20, BLACK);
 
+    DrawRectangleRec(batchBtn, LIGHTGRAY);
+    DrawRectangleLinesEx(batchBtn, 2, DARKGRAY);
+    DrawText("Batch Search", batchBtn.x + 12, batchBtn.y + 5, 20, BLACK);
+
+    DrawRectangleRec(skipBtn, playing ? LIGHTGRAY : RAYWHITE);
+    DrawRectangleLinesEx(skipBtn, 2, DARKGRAY);
+    DrawText("Skip", skipBtn.x + 52, skipBtn.y + 5, 20, playing ? BLACK : GRAY);
+
+    DrawRectangleRec(bulkBtn, bulkTotal > 0 ? SKYBLUE : LIGHTGRAY);
+    DrawRectangleLinesEx(bulkBtn, 2, DARKGRAY);
+    DrawText("Bulk Insert", bulkBtn.x + 18, bulkBtn.y + 5, 20, BLACK);
+
+    DrawRectangleRec(layoutBtn, LIGHTGRAY);
+    DrawRectangleLinesEx(layoutBtn, 2, DARKGRAY);
+    DrawText(layout == TREE_LAYOUT_COMPACT ? "Layout: Compact" : "Layout: Midpoint",
+        layoutBtn.x + 12, layoutBtn.y + 5, 20, BLACK);
+
+    DrawRectangleRec(deleteBtn, LIGHTGRAY);
+    DrawRectangleLinesEx(deleteBtn, 2, DARKGRAY);
+    DrawText("Delete", deleteBtn.x + 28, deleteBtn.y + 5, 20, BLACK);
+
+    bool canUndo = history.Current() > 0, canRedo = history.Current() + 1 < history.VersionCount();
+    DrawRectangleRec(undoBtn, canUndo ? LIGHTGRAY : RAYWHITE);
+    DrawRectangleLinesEx(undoBtn, 2, DARKGRAY);
+    DrawText("Undo", undoBtn.x + 25, undoBtn.y + 5, 20, canUndo ? BLACK : GRAY);
+    DrawRectangleRec(redoBtn, canRedo ? LIGHTGRAY : RAYWHITE);
+    DrawRectangleLinesEx(redoBtn, 2, DARKGRAY);
+    DrawText("Redo", redoBtn.x + 25, redoBtn.y + 5, 20, canRedo ? BLACK : GRAY);
+
+    DrawTimeline();
+    cacheView.Draw();
+    memoryView.Draw();
+
+    if (bulkTotal > 0)
+        DrawText(TextFormat("Bulk insert: %d / %d nodes, %d events queued",
+            bulkApplied, bulkTotal, (int)worker.Queued()), 50, 230, 20, DARKGRAY);
+
     if (!notificationText.empty()) {
         int textWidth = MeasureText(notificationText.c_str(), 20);
         DrawText(notificationText.c_str(),
@@ -5,6 +5,18 @@ BinaryTreeVisualizer::BinaryTreeVisualizer(int width, int height)
     : screenWidth(width), screenHeight(height), tree(width, height), activeInputBox(false) {
 }
 
+BinaryTreeVisualizer::Snapshot BinaryTreeVisualizer::TakeSnapshot() const {
+    Snapshot snapshot;
+    tree.CollectKeys(snapshot.keys);
+    snapshot.layout = tree.Layout();
+    return snapshot;
+}
+
+void BinaryTreeVisualizer::Restore(const Snapshot& snapshot) {
+    for (int key : snapshot.keys) tree.InsertImmediate(key);
+    tree.SetLayout(snapshot.layout); // places the nodes
+}
+
 void BinaryTreeVisualizer::Update() {
     float uiScale = screenWidth / 1600.0f;
 
@@ -29,6 +41,10 @@ void BinaryTreeVisualizer::Update() {
     tree.UpdateAnimations();
 }
 
+void BinaryTreeVisualizer::Tick() {
+    tree.UpdateAnimations();
+}
+
 void BinaryTreeVisualizer::Draw() {
     float uiScale = screenWidth / 1600.0f;
 
@@ -0,0 +1,114 @@
+#include "CacheSim.h"
+
+const CachePreset cachePresets[] = {
+    // A typical desktop core: the structures on screen fit in L1 many times
+    // over, so only cold misses show
+    { "Desktop", 64, { { "L1", 32 * 1024, 8 }, { "L2", 1024 * 1024, 16 }, { "LLC", 32 * 1024 * 1024, 16 } } },
+    // Scaled down until a few dozen nodes overflow it, so capacity and
+    // conflict misses show up with warm replays
+    { "Tiny", 64, { { "L1", 512, 2 }, { "L2", 2048, 4 }, { "LLC", 8192, 8 } } },
+};
+const int cachePresetCount = sizeof(cachePresets) / sizeof(cachePresets[0]);
+
+const char* CacheTraceOpName(CacheTraceOp op) {
+    static const char* names[] = { "Traverse", "Search", "Insert" };
+    return op < CACHE_TRACE_OP_COUNT ? names[op] : "?";
+}
+
+CacheSimulator::CacheSimulator(const CachePreset& preset) : lineBytes(preset.lineBytes) {
+    for (const CacheLevelConfig& config : preset.levels) {
+        LevelState level;
+        level.config = config;
+        level.sets = config.sizeBytes / (lineBytes * config.ways);
+        if (level.sets == 0) level.sets = 1;
+        level.lines.assign((size_t)level.sets * config.ways, 0);
+        level.lastUse.assign(level.lines.size(), 0);
+        level.stats = {};
+        levels.push_back(level);
+    }
+}
+
+void CacheSimulator::Reset() {
+    for (LevelState& level : levels) {
+        level.lines.assign(level.lines.size(), 0);
+        level.lastUse.assign(level.lastUse.size(), 0);
+    }
+    clock = 0;
+    ResetStats();
+}
+
+void CacheSimulator::ResetStats() {
+    for (LevelState& level : levels) level.stats = {};
+    lineAccesses = 0;
+    memoryAccesses = 0;
+}
+
+int CacheSimulator::Access(uintptr_t address, uint32_t bytes) {
+    uint64_t first = address / lineBytes;
+    uint64_t last = (address + (bytes ? bytes : 1) - 1) / lineBytes;
+
+    int slowest = 0;
+    for (uint64_t line = first; line <= last; line++) {
+        int level = AccessLine(line);
+        if (level > slowest) slowest = level;
+    }
+    return slowest;
+}
+
+void CacheSimulator::Replay(const AddressTrace& trace, bool warm, std::vector<int8_t>& elementLevels) {
+    Reset();
+    if (warm) {
+        for (const TraceAccess& a : trace) Access(a.address, a.bytes);
+        ResetStats();
+    }
+
+    int elementCount = 0;
+    for (const TraceAccess& a : trace)
+        if (a.element + 1 > elementCount) elementCount = a.element + 1;
+    elementLevels.assign(elementCount, -1);
+
+    for (const TraceAccess& a : trace) {
+        int level = Access(a.address, a.bytes);
+        if (a.element >= 0 && level > elementLevels[a.element]) elementLevels[a.element] = (int8_t)level;
+    }
+}
+
+int CacheSimulator::AccessLine(uint64_t line) {
+    lineAccesses++;
+    clock++;
+
+    int served = LevelCount();
+    for (int i = 0; i < LevelCount(); i++) {
+        if (Lookup(levels[i], line)) {
+            levels[i].stats.hits++;
+            served = i;
+            break;
+        }
+        levels[i].stats.misses++;
+    }
+    if (served == LevelCount()) memoryAccesses++;
+
+    for (int i = 0; i < served; i++) Fill(levels[i], line);
+    return served;
+}
+
+bool CacheSimulator::Lookup(LevelState& level, uint64_t line) {
+    size_t base = (size_t)(line % level.sets) * level.config.ways;
+    for (uint32_t w = 0; w < level.config.ways; w++) {
+        if (level.lines[base + w] == line + 1) {
+            level.lastUse[base + w] = clock;
+            return true;
+        }
+    }
+    return false;
+}
+
+void CacheSimulator::Fill(LevelState& level, uint64_t line) {
+    // An empty way has stamp 0, so it is always the least recently used
+    size_t base = (size_t)(line % level.sets) * level.config.ways;
+    size_t victim = base;
+    for (uint32_t w = 1; w < level.config.ways; w++)
+        if (level.lastUse[base + w] < level.lastUse[victim]) victim = base + w;
+    level.lines[victim] = line + 1;
+    level.lastUse[victim] = clock;
+}
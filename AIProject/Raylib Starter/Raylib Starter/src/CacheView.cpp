@@ -0,0 +1,113 @@
+#include "CacheView.h"
+
+CacheView::CacheView(Vector2 origin) : cache(cachePresets[0]) {
+    opButton = { origin.x, origin.y, 200, 40 };
+    presetButton = { origin.x + 210, origin.y, 150, 40 };
+    warmButton = { origin.x + 370, origin.y, 100, 40 };
+}
+
+void CacheView::HandleInput() {
+    if (!IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) return;
+    Vector2 mousePos = GetMousePosition();
+
+    // Off -> Traverse -> Search -> Insert -> Off
+    if (CheckCollisionPointRec(mousePos, opButton)) {
+        if (!active) {
+            active = true;
+            op = CACHE_TRACE_TRAVERSE;
+        }
+        else if (op + 1 < CACHE_TRACE_OP_COUNT) {
+            op = (CacheTraceOp)(op + 1);
+        }
+        else {
+            active = false;
+        }
+        dirty = true;
+    }
+    if (!active) return;
+
+    if (CheckCollisionPointRec(mousePos, presetButton)) {
+        preset = (preset + 1) % cachePresetCount;
+        cache = CacheSimulator(cachePresets[preset]);
+        dirty = true;
+    }
+    if (CheckCollisionPointRec(mousePos, warmButton)) {
+        warm = !warm;
+        dirty = true;
+    }
+}
+
+bool CacheView::NeedsReplay(int key, size_t elementCount) {
+    if (!active) return false;
+    if (!dirty && key == lastKey && elementCount == lastCount) return false;
+    dirty = false;
+    lastKey = key;
+    lastCount = elementCount;
+    return true;
+}
+
+AddressTrace& CacheView::BeginTrace() {
+    trace.clear();
+    return trace;
+}
+
+void CacheView::Replay() {
+    cache.Replay(trace, warm, elementLevels);
+}
+
+int CacheView::ElementLevel(size_t element) const {
+    return element < elementLevels.size() ? elementLevels[element] : -1;
+}
+
+Color CacheView::LevelColor(int level, int levelCount) {
+    static const Color colors[] = { GREEN, GOLD, ORANGE };
+    if (level < 0) return BLANK;
+    if (level >= levelCount) return RED; // memory
+    return colors[level < 3 ? level : 2];
+}
+
+void CacheView::DrawMarker(Vector2 center, float radius, size_t element) const {
+    if (!active) return;
+    int level = ElementLevel(element);
+    if (level < 0) return;
+    DrawRing(center, radius, radius + 4, 0, 360, 24, LevelColor(level, cache.LevelCount()));
+}
+
+void CacheView::DrawMarker(Rectangle bounds, size_t element) const {
+    if (!active) return;
+    int level = ElementLevel(element);
+    if (level < 0) return;
+    DrawRectangleLinesEx(bounds, 4, LevelColor(level, cache.LevelCount()));
+}
+
+void CacheView::Draw() const {
+    DrawRectangleRec(opButton, active ? GOLD : LIGHTGRAY);
+    DrawRectangleLinesEx(opButton, 2, DARKGRAY);
+    DrawText(active ? TextFormat("Cache: %s", CacheTraceOpName(op)) : "Cache: Off",
+        opButton.x + 12, opButton.y + 10, 20, BLACK);
+    if (!active) return;
+
+    DrawRectangleRec(presetButton, LIGHTGRAY);
+    DrawRectangleLinesEx(presetButton, 2, DARKGRAY);
+    DrawText(cachePresets[preset].name, presetButton.x + 12, presetButton.y + 10, 20, BLACK);
+
+    DrawRectangleRec(warmButton, LIGHTGRAY);
+    DrawRectangleLinesEx(warmButton, 2, DARKGRAY);
+    DrawText(warm ? "Warm" : "Cold", warmButton.x + 12, warmButton.y + 10, 20, BLACK);
+
+    // Local miss ratio of each level for this one operation
+    int x = (int)opButton.x;
+    int y = (int)(opButton.y + opButton.height + 8);
+    DrawText(TextFormat("%llu line accesses", (unsigned long long)cache.LineAccesses()), x, y, 16, DARKGRAY);
+    x += 170;
+    for (int i = 0; i < cache.LevelCount(); i++) {
+        const CacheLevelStats& s = cache.Stats(i);
+        uint64_t total = s.hits + s.misses;
+        float ratio = total ? 100.0f * s.misses / total : 0.0f;
+        DrawRectangle(x, y + 3, 10, 10, LevelColor(i, cache.LevelCount()));
+        DrawText(TextFormat("%s miss %.0f%%", cache.Level(i).name, ratio), x + 14, y, 16, DARKGRAY);
+        x += 110;
+    }
+    DrawRectangle(x, y + 3, 10, 10, RED);
+    DrawText(TextFormat("mem %llu", (unsigned long long)cache.MemoryAccesses()), x + 14, y, 16, DARKGRAY);
+}
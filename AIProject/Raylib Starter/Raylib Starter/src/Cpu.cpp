@@ -0,0 +1,54 @@
+#include "Cpu.h"
+
+#if !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+static void QueryCpuid(int leaf, int subleaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, leaf, subleaf);
+    for (int i = 0; i < 4; i++) regs[i] = (unsigned int)info[i];
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// AVX state must also be enabled by the OS (XCR0 bits 1 and 2)
+static bool OsSavesAvxState() {
+#if defined(_MSC_VER)
+    return (_xgetbv(0) & 0x6) == 0x6;
+#else
+    unsigned int eax, edx;
+    __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (eax & 0x6) == 0x6;
+#endif
+}
+
+static CpuFeatures DetectCpuFeatures() {
+    CpuFeatures features = { false, false, false, false };
+    unsigned int regs[4];
+
+    QueryCpuid(0, 0, regs);
+    unsigned int maxLeaf = regs[0];
+    if (maxLeaf < 1) return features;
+
+    QueryCpuid(1, 0, regs);
+    features.popcnt = (regs[2] & (1u << 23)) != 0;
+    features.sse41 = (regs[2] & (1u << 19)) != 0 && features.popcnt;
+    bool osxsave = (regs[2] & (1u << 27)) != 0;
+    bool avx = (regs[2] & (1u << 28)) != 0;
+
+    if (maxLeaf >= 7) {
+        QueryCpuid(7, 0, regs);
+        features.bmi1 = (regs[1] & (1u << 3)) != 0;
+        bool avx2 = (regs[1] & (1u << 5)) != 0;
+        features.avx2 = avx2 && osxsave && avx && OsSavesAvxState() && features.sse41 && features.bmi1;
+    }
+    return features;
+}
+
+const CpuFeatures& GetCpuFeatures() {
+    static const CpuFeatures features = DetectCpuFeatures();
+    return features;
+}
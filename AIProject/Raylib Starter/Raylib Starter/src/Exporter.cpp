@@ -0,0 +1,288 @@
+#include "Exporter.h"
+#include "FrameClock.h"
+#include "OffscreenTarget.h"
+#include "Scenario.h"
+#include "raylib.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+// raylib.lib carries its own copies of both libraries (screen recording and
+// ExportImage), so ours must not export the same symbols: stb_image_write can
+// be made static, msf_gif's public functions are renamed
+#define STB_IMAGE_WRITE_STATIC
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "external/stb_image_write.h"
+
+#define msf_gif_begin ExportGifBegin
+#define msf_gif_frame ExportGifFrame
+#define msf_gif_end ExportGifEnd
+#define msf_gif_free ExportGifFree
+#define msf_gif_begin_to_file ExportGifBeginToFile
+#define msf_gif_frame_to_file ExportGifFrameToFile
+#define msf_gif_end_to_file ExportGifEndToFile
+#define msf_gif_alpha_threshold exportGifAlphaThreshold
+#define msf_gif_bgra_flag exportGifBgraFlag
+#define MSF_GIF_IMPL
+#include "external/msf_gif.h"
+
+// Frames held for the encoders (being filled, queued or encoding) stay under this
+static const size_t frameBudgetBytes = 512u << 20;
+static const int gifMaxBitDepth = 16;
+
+// -----------------------------------------------------------------------------
+// FrameEncoder
+// -----------------------------------------------------------------------------
+FrameEncoder::FrameEncoder(ExportFormat format, const std::string& path, int width, int height, float fps,
+    unsigned threadCount)
+    : format(format), path(path), width(width), height(height), fps(fps) {
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    frameBytes = (size_t)width * height * 4;
+
+    // Two segments per encoder: one encoding while the next one waits. GIF
+    // segments restart the frame-to-frame compression, so they're kept long;
+    // PNG frames don't depend on each other, so each is a job of its own.
+    size_t segmentCount = (size_t)threadCount * 2 + 1; // + the one being filled
+    segmentFrames = format == EXPORT_PNG ? 1
+        : std::clamp(frameBudgetBytes / (frameBytes * segmentCount), (size_t)4, (size_t)30);
+
+    if (format == EXPORT_GIF) {
+        gifFile = fopen(path.c_str(), "wb");
+        if (!gifFile) failed = true;
+    }
+    else {
+        std::error_code error;
+        std::filesystem::create_directories(path, error);
+        if (error) failed = true;
+    }
+
+    for (size_t i = 0; i < segmentCount; i++) {
+        segments.push_back(std::make_unique<Segment>());
+        segments.back()->pixels.resize(segmentFrames * frameBytes);
+        freeSegments.push_back(segments.back().get());
+    }
+    for (unsigned i = 0; i < threadCount; i++)
+        threads.emplace_back(&FrameEncoder::EncoderLoop, this);
+}
+
+FrameEncoder::~FrameEncoder() {
+    if (!finished) Finish();
+}
+
+void FrameEncoder::Submit(const void* pixels) {
+    if (!filling) {
+        std::unique_lock<std::mutex> lock(mutex);
+        room.wait(lock, [this] { return !freeSegments.empty(); });
+        filling = freeSegments.back();
+        freeSegments.pop_back();
+        filling->firstFrame = framesSubmitted;
+        filling->count = 0;
+    }
+    memcpy(filling->pixels.data() + filling->count * frameBytes, pixels, frameBytes);
+    filling->count++;
+    framesSubmitted++;
+    if (filling->count == segmentFrames) SubmitSegment();
+}
+
+void FrameEncoder::SubmitSegment() {
+    std::lock_guard<std::mutex> lock(mutex);
+    filling->done = false;
+    queued.push_back(filling);
+    ordered.push_back(filling);
+    filling = nullptr;
+    work.notify_one();
+}
+
+bool FrameEncoder::Finish() {
+    if (filling && filling->count > 0) SubmitSegment();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        room.wait(lock, [this] { return ordered.empty(); });
+        stopping = true;
+    }
+    work.notify_all();
+    for (std::thread& t : threads) t.join();
+    threads.clear();
+
+    if (gifFile) {
+        if (headerWritten && fputc(0x3B, gifFile) == EOF) failed = true; // trailer
+        if (headerWritten) bytesWritten++;
+        if (fclose(gifFile) != 0) failed = true;
+        gifFile = nullptr;
+    }
+    finished = true;
+    return !failed;
+}
+
+void FrameEncoder::EncoderLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        work.wait(lock, [this] { return stopping || !queued.empty(); });
+        if (queued.empty()) return;
+        Segment* segment = queued.front();
+        queued.pop_front();
+
+        lock.unlock();
+        Encode(*segment);
+        lock.lock();
+
+        segment->done = true;
+        WriteFinished();
+    }
+}
+
+void FrameEncoder::Encode(Segment& segment) {
+    // Frames arrive bottom row first; both encoders take a negative pitch
+    int pitch = width * 4;
+    segment.ok = true;
+
+    if (format == EXPORT_GIF) {
+        MsfGifState gif = {};
+        if (!msf_gif_begin(&gif, width, height)) {
+            segment.ok = false;
+            return;
+        }
+        for (size_t f = 0; f < segment.count; f++) {
+            uint8_t* frame = segment.pixels.data() + f * frameBytes;
+            if (!msf_gif_frame(&gif, frame, CentisecondsFor(segment.firstFrame + f), gifMaxBitDepth, -pitch)) {
+                segment.ok = false;
+                return; // msf_gif frees its state on failure
+            }
+        }
+        MsfGifResult result = msf_gif_end(&gif);
+        const uint8_t* data = (const uint8_t*)result.data;
+        segment.encoded.assign(data, data + (data ? result.dataSize : 0));
+        msf_gif_free(result);
+        if (segment.encoded.empty()) segment.ok = false;
+        return;
+    }
+
+    for (size_t f = 0; f < segment.count; f++) {
+        const uint8_t* frame = segment.pixels.data() + f * frameBytes;
+        char file[1024]; // not TextFormat: its buffers are shared between threads
+        snprintf(file, sizeof(file), "%s/frame_%05zu.png", path.c_str(), segment.firstFrame + f);
+        if (!stbi_write_png(file, width, height, 4, frame + (size_t)(height - 1) * pitch, -pitch)) {
+            segment.ok = false;
+            return;
+        }
+    }
+}
+
+void FrameEncoder::WriteFinished() {
+    // Segments go out in order; a finished one waits for those before it
+    const size_t headerBytes = 32; // msf_gif's header; the last byte is the trailer
+    while (!ordered.empty() && ordered.front()->done) {
+        Segment* segment = ordered.front();
+        ordered.pop_front();
+        if (!segment->ok) failed = true;
+
+        if (format == EXPORT_GIF && !failed) {
+            const std::vector<uint8_t>& gif = segment->encoded;
+            if (!headerWritten) {
+                if (fwrite(gif.data(), 1, headerBytes, gifFile) != headerBytes) failed = true;
+                bytesWritten += headerBytes;
+                headerWritten = true;
+            }
+            size_t frames = gif.size() - headerBytes - 1;
+            if (fwrite(gif.data() + headerBytes, 1, frames, gifFile) != frames) failed = true;
+            bytesWritten += frames;
+        }
+        else if (format == EXPORT_PNG) {
+            bytesWritten += segment->count * frameBytes; // raw; the files are compressed
+        }
+
+        segment->encoded.clear();
+        freeSegments.push_back(segment);
+        room.notify_all();
+    }
+}
+
+int FrameEncoder::CentisecondsFor(size_t frame) const {
+    // GIF delays are whole centiseconds; rounding the running total keeps the
+    // pace right on average (60 fps alternates 2 and 1, which many viewers
+    // play slower; the GIF default is 50)
+    double perFrame = 100.0 / fps;
+    return (int)(std::lround((frame + 1) * perFrame) - std::lround(frame * perFrame));
+}
+
+
+static void PrintUsage() {
+    printf("usage: --export <scenario> <out.gif | folder> [--frames N] [--fps F] [--scale S]\n");
+    PrintScenarioNames();
+}
+
+int RunExport(int argc, char** argv) {
+    if (argc < 2) {
+        PrintUsage();
+        return 1;
+    }
+
+    const Scenario* scenario = FindScenario(argv[0]);
+    if (!scenario) {
+        printf("unknown scenario '%s'\n", argv[0]);
+        PrintUsage();
+        return 1;
+    }
+
+    std::string path = argv[1];
+    ExportFormat format = path.size() > 4 && path.compare(path.size() - 4, 4, ".gif") == 0 ? EXPORT_GIF : EXPORT_PNG;
+    int frames = -1;
+    float fps = format == EXPORT_GIF ? 50.0f : 60.0f; // GIF delays are in centiseconds
+    float scale = 1.0f;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--frames") == 0) frames = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--fps") == 0) fps = (float)atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--scale") == 0) scale = (float)atof(argv[i + 1]);
+    }
+    if (fps <= 0.0f || scale <= 0.0f) {
+        PrintUsage();
+        return 1;
+    }
+    // Scenario lengths are given at 60 fps; other rates keep the duration
+    if (frames < 0) frames = (int)(scenario->frames * fps / 60.0f);
+
+    OffscreenTarget target(scale, "Data Structure Visualizer (export)");
+    SetFixedFrameTime(1.0f / fps);
+
+    bool ok;
+    {
+        FrameEncoder encoder(format, path, target.Width(), target.Height(), fps);
+        if (!encoder.Ok()) printf("can't write to '%s'\n", path.c_str());
+
+        ScenarioScene scene;
+        double renderSeconds = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames && encoder.Ok(); frame++) {
+            auto renderStart = std::chrono::steady_clock::now();
+            scenario->step(scene, frame);
+            target.Begin();
+            scenario->draw(scene);
+            target.End();
+
+            Image image = target.Read();
+            if (!OffscreenTarget::BottomUp()) ImageFlipVertical(&image); // the encoder takes GL row order
+            renderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - renderStart).count();
+
+            if (image.data && image.width == target.Width() && image.height == target.Height())
+                encoder.Submit(image.data);
+            UnloadImage(image);
+        }
+        ok = encoder.Finish();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        size_t exported = encoder.FramesSubmitted();
+        printf("%s: %zu frames (%.1f s at %.0f fps) in %.2f s, %.1fx realtime, %s\n", scenario->name, exported,
+            exported / fps, fps, seconds, seconds > 0.0 ? exported / fps / seconds : 0.0, OffscreenTarget::BackendName());
+        printf("  render + readback %.2f ms/frame, %zu-frame segments, %.1f MB %s\n",
+            exported ? renderSeconds * 1000.0 / exported : 0.0, encoder.SegmentFrames(),
+            encoder.BytesWritten() / (1024.0 * 1024.0), format == EXPORT_GIF ? "written" : "of frames");
+        if (!ok) printf("export failed writing '%s'\n", path.c_str());
+        if (exported < (size_t)frames) ok = false;
+    }
+
+    SetFixedFrameTime(0.0f);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,12 @@
+#include "FrameClock.h"
+#include "raylib.h"
+
+static float fixedFrameTime = 0.0f;
+
+float FrameTime() {
+    return fixedFrameTime > 0.0f ? fixedFrameTime : GetFrameTime();
+}
+
+void SetFixedFrameTime(float seconds) {
+    fixedFrameTime = seconds;
+}
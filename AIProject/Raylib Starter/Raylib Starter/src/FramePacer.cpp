@@ -0,0 +1,149 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cmath>
+
+// No raylib here: its names clash with windows.h
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002 // Windows 10 1803 SDK
+#endif
+#else
+#include <cerrno>
+#include <time.h>
+#endif
+
+// Deadlines further behind than this many periods restart from now
+static const int maxPeriodsBehind = 4;
+
+const char* PacingName(PacingMode mode) {
+    switch (mode) {
+    case PACING_SLEEP: return "sleep to deadline";
+    case PACING_RAYLIB: return "raylib (sleep + spin)";
+    default: return "?";
+    }
+}
+
+static double ThreadCpuSeconds() {
+#if defined(_WIN32)
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) return 0.0;
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return (k.QuadPart + u.QuadPart) * 100e-9;
+#else
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0.0;
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+FramePacer::FramePacer(double fps) {
+    SetFps(fps);
+    samples.resize(window);
+    sortedJitter.reserve(window);
+#if defined(_WIN32)
+    // High resolution timers wake within a fraction of a millisecond; older
+    // systems get a plain one, at the 1 ms timer resolution raylib asks for
+    timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (!timer) timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+#endif
+}
+
+FramePacer::~FramePacer() {
+#if defined(_WIN32)
+    if (timer) CloseHandle((HANDLE)timer);
+#endif
+}
+
+void FramePacer::SetFps(double fps) {
+    period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / std::max(fps, 1.0)));
+    Reset();
+}
+
+void FramePacer::Reset() {
+    started = false;
+    sampleCount = 0;
+}
+
+void FramePacer::Wait() {
+    Clock::time_point now = Clock::now();
+    if (!started || now - deadline > period * maxPeriodsBehind) {
+        deadline = now; // first frame, or after a stall: no sleep, no burst
+        started = true;
+    }
+    else {
+        deadline += period;
+        if (deadline > now) SleepUntil(deadline);
+    }
+    Record(Clock::now());
+}
+
+void FramePacer::Observe() {
+    started = false; // Wait starts over if pacing switches back
+    Record(Clock::now());
+}
+
+void FramePacer::SleepUntil(Clock::time_point when) {
+#if defined(_WIN32)
+    // Waitable timers take relative due times in 100 ns units (negative)
+    Clock::time_point now = Clock::now();
+    if (!timer || when <= now) return;
+    LARGE_INTEGER due;
+    due.QuadPart = -(LONGLONG)std::chrono::duration_cast<std::chrono::duration<LONGLONG, std::ratio<1, 10000000>>>(
+        when - now).count();
+    if (due.QuadPart == 0) return;
+    if (SetWaitableTimer((HANDLE)timer, &due, 0, nullptr, nullptr, FALSE))
+        WaitForSingleObject((HANDLE)timer, INFINITE);
+#else
+    // steady_clock is CLOCK_MONOTONIC, so its time points are valid deadlines
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(when.time_since_epoch()).count();
+    timespec ts;
+    ts.tv_sec = (time_t)(ns / 1000000000);
+    ts.tv_nsec = (long)(ns % 1000000000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+#endif
+}
+
+void FramePacer::Record(Clock::time_point now) {
+    samples[sampleCount % window] = { now, ThreadCpuSeconds() };
+    sampleCount++;
+}
+
+PacingStats FramePacer::Stats() {
+    PacingStats stats = {};
+    size_t count = std::min(sampleCount, (size_t)window);
+    if (count < 2) return stats;
+
+    // Oldest to newest around the ring
+    size_t first = sampleCount - count;
+    double periodMs = std::chrono::duration<double, std::milli>(period).count();
+    double sum = 0.0;
+    sortedJitter.clear();
+    for (size_t i = first + 1; i < sampleCount; i++) {
+        const Sample& a = samples[(i - 1) % window];
+        const Sample& b = samples[i % window];
+        double jitter = std::fabs(std::chrono::duration<double, std::milli>(b.wall - a.wall).count() - periodMs);
+        sortedJitter.push_back(jitter);
+        sum += jitter;
+        if (jitter > 1.0) stats.framesOver1Ms++;
+    }
+    std::sort(sortedJitter.begin(), sortedJitter.end());
+
+    stats.frames = sortedJitter.size();
+    stats.meanJitterMs = sum / stats.frames;
+    stats.p99JitterMs = sortedJitter[std::min(stats.frames - 1, (size_t)(stats.frames * 0.99))];
+    stats.maxJitterMs = sortedJitter.back();
+
+    const Sample& oldest = samples[first % window];
+    const Sample& newest = samples[(sampleCount - 1) % window];
+    double wall = std::chrono::duration<double>(newest.wall - oldest.wall).count();
+    if (wall > 0.0) stats.cpuPercent = 100.0 * (newest.cpuSeconds - oldest.cpuSeconds) / wall;
+    return stats;
+}
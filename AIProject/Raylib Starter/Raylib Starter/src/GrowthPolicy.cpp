@@ -0,0 +1,18 @@
+#include "GrowthPolicy.h"
+
+const char* GrowthPolicyName(GrowthPolicy policy) {
+    static const char* names[] = { "Fixed", "1.5x", "2x", "Exact fit" };
+    return policy < GROWTH_COUNT ? names[policy] : "?";
+}
+
+size_t GrowCapacity(GrowthPolicy policy, size_t capacity) {
+    size_t grown = capacity;
+    switch (policy) {
+    case GROWTH_FIXED: return capacity;
+    case GROWTH_1_5X: grown = capacity + capacity / 2; break;
+    case GROWTH_2X: grown = capacity * 2; break;
+    case GROWTH_EXACT: grown = capacity + 1; break;
+    default: break;
+    }
+    return grown > capacity ? grown : capacity + 1;
+}
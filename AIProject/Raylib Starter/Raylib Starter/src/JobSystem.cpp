@@ -0,0 +1,99 @@
+#include "JobSystem.h"
+
+// Which pool (if any) the current thread works for, and its queue
+static thread_local const JobSystem* currentSystem = nullptr;
+static thread_local unsigned currentQueue = 0;
+
+JobSystem::JobSystem(unsigned threads) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    for (unsigned i = 0; i < threads; i++)
+        queues.push_back(std::make_unique<Queue>());
+    for (unsigned i = 1; i < threads; i++)
+        workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+unsigned JobSystem::QueueIndex() const {
+    return currentSystem == this ? currentQueue : 0;
+}
+
+void JobSystem::Push(const Job& job) {
+    Queue& queue = *queues[QueueIndex()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.jobs.push_back(job);
+    queued.fetch_add(1);
+}
+
+void JobSystem::WakeWorkers() {
+    // Taking the lock orders this with a worker that is about to sleep
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    wake.notify_all();
+}
+
+bool JobSystem::RunOne() {
+    unsigned self = QueueIndex();
+    Job job;
+    bool found = false;
+
+    // Newest job of our own first (its data is still in cache)...
+    {
+        Queue& own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            found = true;
+        }
+    }
+
+    // ...otherwise the oldest job of someone else
+    for (size_t i = 1; i < queues.size() && !found; i++) {
+        Queue& victim = *queues[(self + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            found = true;
+        }
+    }
+    if (!found) return false;
+
+    queued.fetch_sub(1);
+    job.run(job.context, job.begin, job.end);
+    job.pending->fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void JobSystem::Wait(std::atomic<size_t>& pending) {
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (!RunOne()) std::this_thread::yield();
+    }
+}
+
+void JobSystem::WorkerLoop(unsigned index) {
+    currentSystem = this;
+    currentQueue = index;
+
+    while (true) {
+        if (RunOne()) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping.load() || queued.load() > 0; });
+        if (stopping && queued.load() == 0) return;
+    }
+}
+
+JobSystem& GetJobSystem() {
+    static JobSystem system;
+    return system;
+}
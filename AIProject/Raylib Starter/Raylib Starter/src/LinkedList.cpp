@@ -1,5 +1,10 @@
 #include "LinkedList.h"
+#include "FrameClock.h"
+#include "Profiler.h"
+#include "AllocationTracker.h"
 #include <algorithm>
+#include <cstddef>
+#include <unordered_map>
 
 // -----------------------------------------------------------------------------
 // Node
@@ -8,35 +13,18 @@ Node::Node(int v, float xpos, float ypos)
     : value(v), next(nullptr), x(xpos), y(ypos) {
 }
 
-// -----------------------------------------------------------------------------
-// AnimatedNode
-// -----------------------------------------------------------------------------
-AnimatedNode::AnimatedNode(Node* n, float targetY)
-    : node(n), targetY(targetY) {
-}
-
 // -----------------------------------------------------------------------------
 // AnimatedPointer
 // -----------------------------------------------------------------------------
 AnimatedPointer::AnimatedPointer(Vector2 s, Vector2 e)
-    : start(s), end(e), current(s), active(true), progress(0.0f), speed(0.05f) {
-}
-
-void AnimatedPointer::Update() {
-    if (!active) return;
-    progress += speed;
-    if (progress >= 1.0f) {
-        progress = 1.0f;
-        active = false;
-    }
-    current.x = start.x + (end.x - start.x) * progress;
-    current.y = start.y + (end.y - start.y) * progress;
+    : start(s), end(e), progress(0.0f) {
 }
 
 void AnimatedPointer::Draw() {
     if (progress > 0.0f) {
+        Vector2 current = { start.x + (end.x - start.x) * progress, start.y + (end.y - start.y) * progress };
         DrawLineEx(start, current, 2, DARKGRAY);
-        if (!active) {
+        if (IsFinished()) {
             DrawTriangle(
                 end,
                 { end.x - 10, end.y - 5 },
@@ -48,7 +36,7 @@ void AnimatedPointer::Draw() {
 }
 
 bool AnimatedPointer::IsFinished() const {
-    return !active;
+    return progress >= 1.0f;
 }
 
 // -----------------------------------------------------------------------------
@@ -58,7 +46,57 @@ LinkedList::LinkedList() : head(nullptr) {}
 
 LinkedList::~LinkedList() {
     for (Node* node : nodes)
-        delete node;
+        FreeNode(node);
+}
+
+Node* LinkedList::NewNode(int value, float x, float y) {
+    return usePool ? pool.Create(value, x, y) : new Node(value, x, y);
+}
+
+void LinkedList::FreeNode(Node* node) {
+    if (usePool) pool.Destroy(node);
+    else delete node;
+}
+
+void LinkedList::SetPooled(bool pooled) {
+    if (pooled == usePool) return;
+
+    // Tweens point into the nodes: let them land first
+    tweens.FinishAll();
+
+    // Old addresses are only used as keys, so each node can be freed as soon
+    // as it has been copied
+    std::unordered_map<Node*, Node*> moved;
+    for (Node*& node : nodes) {
+        Node* copy = pooled ? pool.Create(*node) : new Node(*node);
+        moved[node] = copy;
+        FreeNode(node);
+        node = copy;
+    }
+    usePool = pooled;
+    if (!pooled) pool.Release();
+
+    for (Node* node : nodes)
+        if (node->next) node->next = moved[node->next];
+    if (head) head = moved[head];
+    for (Node*& node : droppingNodes) node = moved[node];
+}
+
+void LinkedList::CollectNodes(std::vector<const void*>& out) const {
+    for (Node* node : nodes) out.push_back(node);
+}
+
+size_t LinkedList::FootprintBytes() const {
+    if (usePool) return pool.FootprintBytes();
+    size_t bytes = 0;
+    for (Node* node : nodes) bytes += AllocationFootprint(node, sizeof(Node));
+    return bytes;
+}
+
+long long LinkedList::SumValues() const {
+    long long sum = 0;
+    for (const Node* node = head; node; node = node->next) sum += node->value;
+    return sum;
 }
 
 void LinkedList::AddNode(int value) {
@@ -66,11 +104,23 @@ void LinkedList::AddNode(int value) {
     float y = screenHeight / 2.0f;
     float spacing = 120.0f;
 
-    Node* newNode = new Node(value, startX + nodes.size() * spacing, -50);
-    animatedNodes.push_back(AnimatedNode(newNode, y));
+    Node* newNode = NewNode(value, startX + nodes.size() * spacing, -50);
+    tweens.Add(&newNode->y, y, 1.2f);
+    droppingNodes.push_back(newNode);
     nodes.push_back(newNode);
 }
 
+void LinkedList::LoadValues(const std::vector<int>& values) {
+    float startX = 50.0f;
+    float y = screenHeight / 2.0f;
+    float spacing = 120.0f;
+
+    nodes.reserve(nodes.size() + values.size());
+    for (int value : values)
+        nodes.push_back(NewNode(value, startX + nodes.size() * spacing, y));
+    UpdateLinks();
+}
+
 void LinkedList::InsertNodeAt(int index, int value) {
     if (index < 0 || index > nodes.size()) return;
 
@@ -78,13 +128,14 @@ void LinkedList::InsertNodeAt(int index, int value) {
     float spacing = 120.0f;
     float targetY = screenHeight / 2.0f;
 
-    Node* newNode = new Node(value, startX + index * spacing, -50);
-    animatedNodes.push_back(AnimatedNode(newNode, targetY));
+    Node* newNode = NewNode(value, startX + index * spacing, -50);
+    tweens.Add(&newNode->y, targetY, 1.2f);
+    droppingNodes.push_back(newNode);
     nodes.insert(nodes.begin() + index, newNode);
 
-    // Shift nodes after insertion
+    // Slide the nodes after it over to make room
     for (int i = index + 1; i < nodes.size(); ++i) {
-        nodes[i]->x += spacing;
+        tweens.Add(&nodes[i]->x, startX + i * spacing, 0.4f);
     }
 }
 
@@ -93,14 +144,21 @@ void LinkedList::DeleteLastNode() {
 
     Node* last = nodes.back();
     nodes.pop_back();
-    delete last;
+
+    // It may still be dropping in (or sliding over)
+    tweens.CancelRange(last, sizeof(Node));
+    droppingNodes.erase(std::remove(droppingNodes.begin(), droppingNodes.end(), last), droppingNodes.end());
+    FreeNode(last);
     if (nodes.empty()) head = nullptr;
     else nodes.back()->next = nullptr;
 }
 
 void LinkedList::UpdateLinks() {
+    ProfileScope scope(PHASE_LAYOUT);
     head = nodes.empty() ? nullptr : nodes[0];
+    tweens.CancelRange(animatedPointers.data(), animatedPointers.size() * sizeof(AnimatedPointer));
     animatedPointers.clear();
+    if (!nodes.empty()) animatedPointers.reserve(nodes.size() - 1);
 
     for (int i = 0; i < nodes.size(); ++i) {
         if (i < nodes.size() - 1) {
@@ -114,47 +172,60 @@ void LinkedList::UpdateLinks() {
             nodes[i]->next = nullptr;
         }
     }
+
+    // Reserved up front, so the pointers stay put while their tweens run
+    for (AnimatedPointer& pointer : animatedPointers)
+        tweens.Add(&pointer.progress, 1.0f, 0.33f, EASE_LINEAR);
 }
 
 void LinkedList::UpdateAnimations() {
-    const float speed = 5.0f;
+    ProfileScope scope(PHASE_ANIMATION_TICK);
+    tweens.Tick(FrameTime());
+
+    // Once a node has landed, finalize link updates (once per frame, however
+    // many nodes landed)
+    size_t moving = droppingNodes.size();
+    droppingNodes.erase(
+        std::remove_if(droppingNodes.begin(), droppingNodes.end(),
+            [this](Node* node) { return !tweens.Active(&node->y); }),
+        droppingNodes.end()
+    );
+    if (droppingNodes.size() != moving) UpdateLinks();
 
-    for (auto& anim : animatedNodes) {
-        if (anim.node->y < anim.targetY) {
-            anim.node->y += speed;
-            if (anim.node->y > anim.targetY) anim.node->y = anim.targetY;
-        }
-    }
+    // The pointer tweens all start together, so they finish together too
+    bool drawn = std::all_of(animatedPointers.begin(), animatedPointers.end(),
+        [](const AnimatedPointer& p) { return p.IsFinished(); });
+    if (drawn) animatedPointers.clear();
+}
 
-    // Once a node has reached targetY, finalize link updates
-    animatedNodes.erase(
-        std::remove_if(animatedNodes.begin(), animatedNodes.end(),
-            [this](const AnimatedNode& anim) {
-                if (anim.node->y >= anim.targetY) {
-                    UpdateLinks();
-                    return true;
-                }
-                return false;
-            }),
-        animatedNodes.end()
-    );
+void LinkedList::TraceOperation(CacheTraceOp op, int key, AddressTrace& trace) const {
+    // Every step reads the value and next pointer at the front of the node.
+    // The nodes vector holds the list order; the next links lag behind it
+    // while new nodes are still dropping in.
+    const size_t stepBytes = offsetof(Node, next) + sizeof(Node*);
 
-    for (auto& pointer : animatedPointers)
-        pointer.Update();
+    size_t stop = nodes.size();
+    if (op == CACHE_TRACE_INSERT)
+        stop = key < 0 ? 0 : std::min((size_t)key, nodes.size()); // up to the predecessor
 
-    animatedPointers.erase(
-        std::remove_if(animatedPointers.begin(), animatedPointers.end(),
-            [](const AnimatedPointer& p) { return p.IsFinished(); }),
-        animatedPointers.end()
-    );
+    for (size_t i = 0; i < stop; i++) {
+        RecordAccess(trace, nodes[i], stepBytes, (int)i);
+        if (op == CACHE_TRACE_SEARCH && nodes[i]->value == key) break;
+    }
+}
+
+void LinkedList::DrawCacheLevels(const CacheView& view) const {
+    for (size_t i = 0; i < nodes.size(); i++)
+        view.DrawMarker({ nodes[i]->x - 4, nodes[i]->y - 4, 88, 48 }, i);
 }
 
 void LinkedList::Draw() {
+    ProfileScope scope(PHASE_DRAW);
     // Draw nodes
     for (Node* node : nodes) {
         DrawRectangle(node->x, node->y, 80, 40, SKYBLUE);
         DrawRectangleLines(node->x, node->y, 80, 40, DARKBLUE);
-        DrawText(std::to_string(node->value).c_str(), node->x + 20, node->y + 10, 20, BLACK);
+        DrawText(TextFormat("%d", node->value), node->x + 20, node->y + 10, 20, BLACK);
     }
 
     // Draw animated pointers
@@ -1,8 +1,22 @@
 #include "LinkedListVisualizer.h"
+#include "Profiler.h"
 #include <cctype>
+#include <cstdlib>
 
 LinkedListVisualizer::LinkedListVisualizer()
-    : activeValueBox(false), activeIndexBox(false) {
+    : activeValueBox(false), activeIndexBox(false), cacheView({ 980, 100 }),
+      memoryView({ 30, 160 }, { 50, screenHeight - 140.0f, screenWidth - 100.0f, 30 }) {
+}
+
+LinkedListVisualizer::Snapshot LinkedListVisualizer::TakeSnapshot() const {
+    Snapshot snapshot;
+    snapshot.values.reserve(list.Size());
+    for (size_t i = 0; i < list.Size(); i++) snapshot.values.push_back(list.ValueAt(i));
+    return snapshot;
+}
+
+void LinkedListVisualizer::Restore(const Snapshot& snapshot) {
+    list.LoadValues(snapshot.values);
 }
 
 bool LinkedListVisualizer::Button(Rectangle rect, const char* label, float uiScale) {
@@ -20,6 +34,7 @@ void LinkedListVisualizer::DrawInputBox(Rectangle rect, std::string& input, bool
 }
 
 void LinkedListVisualizer::Update() {
+    ProfileScope scope(PHASE_INPUT);
     float uiScale = screenWidth / 1600.0f;
 
     Rectangle valueBox = { 30 * uiScale, 100 * uiScale, 140 * uiScale, 35 * uiScale };
@@ -71,10 +86,40 @@ void LinkedListVisualizer::Update() {
     if (Button(deleteLastBtn, "Delete Last", uiScale))
         list.DeleteLastNode();
 
+    // Cache view: search for the typed value (default the last node), insert
+    // at the typed index (default the end)
+    cacheView.HandleInput();
+    int cacheKey = 0;
+    if (cacheView.Op() == CACHE_TRACE_SEARCH)
+        cacheKey = !inputValue.empty() ? atoi(inputValue.c_str()) : list.Size() ? list.ValueAt(list.Size() - 1) : 0;
+    else if (cacheView.Op() == CACHE_TRACE_INSERT)
+        cacheKey = !inputIndex.empty() ? atoi(inputIndex.c_str()) : (int)list.Size();
+    if (cacheView.NeedsReplay(cacheKey, list.Size())) {
+        list.TraceOperation(cacheView.Op(), cacheKey, cacheView.BeginTrace());
+        cacheView.Replay();
+    }
+
+    // Memory view: move the nodes if the storage was switched, then plot them
+    memoryView.HandleInput();
+    if (memoryView.PoolRequested() != list.Pooled()) {
+        list.SetPooled(memoryView.PoolRequested());
+        memoryView.Invalidate();
+        cacheView.Invalidate();
+    }
+    if (memoryView.NeedsRefresh(list.Size())) {
+        list.CollectNodes(memoryView.BeginCollect());
+        memoryView.Refresh(sizeof(Node), list.FootprintBytes());
+    }
+
+    list.UpdateAnimations();
+}
+
+void LinkedListVisualizer::Tick() {
     list.UpdateAnimations();
 }
 
 void LinkedListVisualizer::Draw() {
+    ProfileScope scope(PHASE_DRAW);
     float uiScale = screenWidth / 1600.0f;
     Rectangle valueBox = { 30 * uiScale, 100 * uiScale, 140 * uiScale, 35 * uiScale };
     Rectangle indexBox = { 200 * uiScale, 100 * uiScale, 140 * uiScale, 35 * uiScale };
@@ -86,4 +131,7 @@ void LinkedListVisualizer::Draw() {
     DrawInputBox(indexBox, inputIndex, activeIndexBox, uiScale);
 
     list.Draw();
+    if (cacheView.Active()) list.DrawCacheLevels(cacheView);
+    cacheView.Draw();
+    memoryView.Draw();
 }
@@ -0,0 +1,116 @@
+#include "MemoryLayoutView.h"
+#include <algorithm>
+#include <cmath>
+
+MemoryLayoutView::MemoryLayoutView(Vector2 origin, Rectangle strip) : strip(strip) {
+    toggleButton = { origin.x, origin.y, 180, 40 };
+    poolButton = { origin.x + 190, origin.y, 150, 40 };
+}
+
+void MemoryLayoutView::HandleInput() {
+    if (!IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) return;
+    Vector2 mousePos = GetMousePosition();
+
+    if (CheckCollisionPointRec(mousePos, toggleButton)) {
+        active = !active;
+        dirty = true;
+    }
+    if (CheckCollisionPointRec(mousePos, poolButton)) {
+        pooled = !pooled;
+        dirty = true;
+    }
+}
+
+bool MemoryLayoutView::NeedsRefresh(size_t nodeCount) {
+    if (!active) return false;
+    if (!dirty && nodeCount == lastCount) return false;
+    dirty = false;
+    lastCount = nodeCount;
+    return true;
+}
+
+std::vector<const void*>& MemoryLayoutView::BeginCollect() {
+    nodes.clear();
+    return nodes;
+}
+
+void MemoryLayoutView::Refresh(size_t nodeBytes, size_t footprintBytes) {
+    this->nodeBytes = nodeBytes;
+    this->footprintBytes = footprintBytes;
+    columns.assign((size_t)strip.width, 0);
+    busiestColumn = 0;
+    nodeX.clear();
+    spanBytes = medianGap = 0;
+    adjacentFraction = 0.0f;
+    if (nodes.empty()) return;
+
+    auto [lowest, highest] = std::minmax_element(nodes.begin(), nodes.end());
+    uintptr_t low = (uintptr_t)*lowest;
+    spanBytes = (uintptr_t)*highest + nodeBytes - low;
+
+    for (size_t i = 0; i < nodes.size(); i++) {
+        double at = (double)((uintptr_t)nodes[i] - low) / spanBytes;
+        size_t column = std::min(columns.size() - 1, (size_t)(at * columns.size()));
+        busiestColumn = std::max(busiestColumn, ++columns[column]);
+        if (nodes.size() <= linkLimit) nodeX.push_back(strip.x + (float)(at * strip.width));
+    }
+
+    // Distance from every node to the next one in logical order
+    std::vector<uintptr_t> gaps;
+    gaps.reserve(nodes.size());
+    size_t adjacent = 0;
+    for (size_t i = 1; i < nodes.size(); i++) {
+        uintptr_t a = (uintptr_t)nodes[i - 1], b = (uintptr_t)nodes[i];
+        uintptr_t gap = a < b ? b - a : a - b;
+        gaps.push_back(gap);
+        if (gap < 64) adjacent++;
+    }
+    if (!gaps.empty()) {
+        std::nth_element(gaps.begin(), gaps.begin() + gaps.size() / 2, gaps.end());
+        medianGap = gaps[gaps.size() / 2];
+        adjacentFraction = (float)adjacent / gaps.size();
+    }
+}
+
+void MemoryLayoutView::Draw() const {
+    DrawRectangleRec(toggleButton, active ? GOLD : LIGHTGRAY);
+    DrawRectangleLinesEx(toggleButton, 2, DARKGRAY);
+    DrawText(active ? "Memory: On" : "Memory: Off", toggleButton.x + 12, toggleButton.y + 10, 20, BLACK);
+
+    DrawRectangleRec(poolButton, pooled ? SKYBLUE : LIGHTGRAY);
+    DrawRectangleLinesEx(poolButton, 2, DARKGRAY);
+    DrawText(pooled ? "Alloc: Pool" : "Alloc: new", poolButton.x + 12, poolButton.y + 10, 20, BLACK);
+    if (!active) return;
+
+    DrawRectangleRec(strip, Fade(LIGHTGRAY, 0.6f));
+    DrawRectangleLinesEx(strip, 1, GRAY);
+
+    // Occupancy: darker columns hold more nodes
+    for (size_t c = 0; c < columns.size(); c++) {
+        if (!columns[c]) continue;
+        float density = 0.35f + 0.65f * columns[c] / busiestColumn;
+        DrawRectangle((int)(strip.x + c), (int)strip.y, 1, (int)strip.height, Fade(DARKBLUE, density));
+    }
+
+    // Arcs above the strip from each node to its logical successor; long
+    // arcs are the pointer chases that leave the cache line
+    for (size_t i = 1; i < nodeX.size(); i++) {
+        float a = nodeX[i - 1], b = nodeX[i];
+        float height = std::min(60.0f, 8.0f + fabsf(b - a) / 4.0f);
+        Vector2 from = { a, strip.y };
+        Vector2 top = { (a + b) / 2, strip.y - height };
+        Vector2 to = { b, strip.y };
+        Color color = ColorFromHSV(270.0f * i / nodeX.size(), 0.8f, 0.8f);
+        DrawLineV(from, top, color);
+        DrawLineV(top, to, color);
+    }
+
+    size_t liveBytes = nodes.size() * nodeBytes;
+    float overhead = liveBytes ? 100.0f * ((float)footprintBytes - liveBytes) / liveBytes : 0.0f;
+    DrawText(TextFormat("%d nodes x %d B   footprint %.1f KiB (%+.0f%% over the nodes)   span %.1f KiB",
+        (int)nodes.size(), (int)nodeBytes, footprintBytes / 1024.0f, overhead, spanBytes / 1024.0f),
+        (int)strip.x, (int)(strip.y + strip.height + 6), 18, DARKGRAY);
+    DrawText(TextFormat("next node: median %llu B away, %.0f%% less than a cache line apart",
+        (unsigned long long)medianGap, adjacentFraction * 100.0f),
+        (int)strip.x, (int)(strip.y + strip.height + 28), 18, DARKGRAY);
+}
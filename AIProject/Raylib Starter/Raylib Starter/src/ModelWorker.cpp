@@ -0,0 +1,53 @@
+#include "ModelWorker.h"
+#include <chrono>
+
+ModelWorker::ModelWorker(size_t queueCapacity) : queue(queueCapacity) {
+}
+
+ModelWorker::~ModelWorker() {
+    Cancel();
+}
+
+void ModelWorker::Run(std::function<void(ModelWorker&)> job) {
+    Cancel();
+    cancelled.store(false);
+    running.store(true);
+    thread = std::thread([this, job = std::move(job)] {
+        // A job that throws (out of memory, say) ends as if it were cancelled;
+        // an exception leaving the thread would terminate the program
+        try {
+            job(*this);
+        }
+        catch (...) {
+        }
+        running.store(false, std::memory_order_release);
+    });
+}
+
+void ModelWorker::Cancel() {
+    cancelled.store(true);
+    if (thread.joinable()) thread.join();
+
+    // The producer is gone, so the render thread can empty the ring alone
+    VisEvent dropped;
+    while (queue.TryPop(dropped)) {}
+}
+
+bool ModelWorker::Busy() const {
+    // running is checked first: once it reads false every event is already queued
+    return running.load(std::memory_order_acquire) || queue.Size() != 0;
+}
+
+void ModelWorker::WaitForOutput() const {
+    while (running.load(std::memory_order_acquire) && queue.Size() < queue.Capacity())
+        std::this_thread::yield();
+}
+
+bool ModelWorker::Publish(const VisEvent& event) {
+    while (!queue.TryPush(event)) {
+        if (Cancelled()) return false;
+        // Full: the render thread drains about once a frame, no point spinning
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return !Cancelled();
+}
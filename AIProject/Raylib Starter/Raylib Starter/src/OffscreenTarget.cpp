@@ -0,0 +1,85 @@
+#include "OffscreenTarget.h"
+#include "globals.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <cstdlib>
+
+OffscreenTarget::OffscreenTarget(float scale, const char* title)
+    : width(std::max(1, (int)(screenWidth * scale))), height(std::max(1, (int)(screenHeight * scale))) {
+#if defined(PLATFORM_DESKTOP_SDL)
+    // No display needed; an SDL_VIDEODRIVER already set still wins
+#if defined(_WIN32)
+    if (!getenv("SDL_VIDEODRIVER")) _putenv_s("SDL_VIDEODRIVER", "offscreen");
+#else
+    setenv("SDL_VIDEODRIVER", "offscreen", 0);
+#endif
+#endif
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    SetTraceLogLevel(LOG_WARNING);
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    InitWindow(width, height, title);
+#else
+    InitWindow(screenWidth, screenHeight, title);
+    texture = LoadRenderTexture(width, height);
+#endif
+    camera.zoom = scale;
+}
+
+OffscreenTarget::~OffscreenTarget() {
+    if (texture.id != 0) UnloadRenderTexture(texture);
+    CloseWindow();
+}
+
+const char* OffscreenTarget::BackendName() {
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    return "software (rlsw)";
+#else
+    switch (rlGetVersion()) {
+    case RL_OPENGL_11: return "OpenGL 1.1";
+    case RL_OPENGL_21: return "OpenGL 2.1";
+    case RL_OPENGL_33: return "OpenGL 3.3";
+    case RL_OPENGL_43: return "OpenGL 4.3";
+    case RL_OPENGL_ES_20: return "OpenGL ES 2.0";
+    case RL_OPENGL_ES_30: return "OpenGL ES 3.0";
+    default: return "unknown";
+    }
+#endif
+}
+
+void OffscreenTarget::Begin() {
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    BeginDrawing();
+#else
+    BeginTextureMode(texture);
+#endif
+    ClearBackground(RAYWHITE);
+    BeginMode2D(camera);
+}
+
+void OffscreenTarget::End() {
+    EndMode2D();
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    EndDrawing();
+#else
+    EndTextureMode();
+#endif
+}
+
+Image OffscreenTarget::Read() {
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    Image image = LoadImageFromScreen();
+#else
+    Image image = LoadImageFromTexture(texture.texture);
+#endif
+    if (image.data && image.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+        ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    return image;
+}
+
+bool OffscreenTarget::BottomUp() {
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    return false; // LoadImageFromScreen flips
+#else
+    return true;
+#endif
+}
@@ -0,0 +1,115 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+PerfCounters::PerfCounters() : reason("not opened") {
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        fds[c] = -1;
+        values[c] = 0;
+    }
+}
+
+const char* PerfCounters::Name(PerfCounter counter) {
+    static const char* names[] = { "cycles", "instr", "L1D miss", "LLC miss", "br miss" };
+    return counter < PERF_COUNTER_COUNT ? names[counter] : "?";
+}
+
+#ifdef __linux__
+
+static uint64_t CacheMissConfig(uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds)
+        if (fd >= 0) close(fd);
+}
+
+bool PerfCounters::Open() {
+    struct Event { uint32_t type; uint64_t config; };
+    const Event events[PERF_COUNTER_COUNT] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, CacheMissConfig(PERF_COUNT_HW_CACHE_L1D) },
+        { PERF_TYPE_HW_CACHE, CacheMissConfig(PERF_COUNT_HW_CACHE_LL) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    };
+
+    int opened = 0;
+    int firstError = 0;
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        if (fds[c] >= 0) {
+            opened++;
+            continue;
+        }
+
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events[c].type;
+        attr.config = events[c].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1; // also what perf_event_paranoid = 2 allows
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // This thread only, on whichever CPU it runs
+        fds[c] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fds[c] >= 0) opened++;
+        else if (!firstError) firstError = errno;
+    }
+
+    if (opened == 0) reason = firstError ? strerror(firstError) : "no counters";
+    else reason = opened < PERF_COUNTER_COUNT ? "some counters missing" : "ok";
+    return opened > 0;
+}
+
+void PerfCounters::Start() {
+    for (int fd : fds) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void PerfCounters::Stop() {
+    for (int fd : fds)
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        values[c] = 0;
+        uint64_t data[3]; // value, time enabled, time running
+        if (fds[c] < 0 || read(fds[c], data, sizeof(data)) != (ssize_t)sizeof(data)) continue;
+
+        // With more events than hardware counters the kernel time-slices them
+        if (data[2] > 0 && data[2] < data[1])
+            values[c] = (uint64_t)((double)data[0] * data[1] / data[2]);
+        else
+            values[c] = data[0];
+    }
+}
+
+#else
+
+PerfCounters::~PerfCounters() {
+}
+
+bool PerfCounters::Open() {
+    reason = "perf_event_open is Linux only";
+    return false;
+}
+
+void PerfCounters::Start() {
+}
+
+void PerfCounters::Stop() {
+}
+
+#endif
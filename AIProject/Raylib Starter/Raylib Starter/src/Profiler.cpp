@@ -0,0 +1,106 @@
+#include "Profiler.h"
+#include <cstdio>
+
+Profiler::Profiler()
+    : ring(historySize), owner(std::this_thread::get_id()),
+      frameStart(Clock::now()), lastSwitch(frameStart) {
+}
+
+void Profiler::BeginFrame() {
+    owner = std::this_thread::get_id();
+    frameStart = lastSwitch = Clock::now();
+    frameStartAllocations = GetAllocationStats();
+    lastSwitchAllocations = GetThreadAllocationStats().allocations;
+    depth = 0;
+    for (double& s : phaseSeconds) s = 0.0;
+    for (uint64_t& a : phaseAllocations) a = 0;
+}
+
+void Profiler::EndFrame() {
+    Clock::time_point now = Clock::now();
+    size_t index = written.load(std::memory_order_relaxed);
+
+    FrameSample& sample = ring[index & (historySize - 1)];
+    sample.frame = index;
+    sample.frameMs = (float)(std::chrono::duration<double>(now - frameStart).count() * 1000.0);
+    for (int p = 0; p < PHASE_COUNT; p++)
+        sample.phaseMs[p] = (float)(phaseSeconds[p] * 1000.0);
+
+    AllocationStats allocations = GetAllocationStats();
+    sample.allocations = (uint32_t)(allocations.allocations - frameStartAllocations.allocations);
+    sample.allocatedBytes = (uint32_t)(allocations.bytes - frameStartAllocations.bytes);
+    for (int p = 0; p < PHASE_COUNT; p++)
+        sample.phaseAllocations[p] = (uint32_t)phaseAllocations[p];
+
+    written.store(index + 1, std::memory_order_release);
+}
+
+bool Profiler::Enter(ProfilePhase phase) {
+    if (std::this_thread::get_id() != owner || depth == (int)(sizeof(stack) / sizeof(stack[0])))
+        return false;
+
+    // The enclosing scope stops accumulating while this one runs
+    ChargeOpenScope(Clock::now());
+    stack[depth++] = phase;
+    return true;
+}
+
+void Profiler::Leave() {
+    ChargeOpenScope(Clock::now());
+    depth--;
+}
+
+void Profiler::ChargeOpenScope(Clock::time_point now) {
+    uint64_t allocations = GetThreadAllocationStats().allocations;
+    if (depth > 0) {
+        ProfilePhase phase = stack[depth - 1];
+        phaseSeconds[phase] += std::chrono::duration<double>(now - lastSwitch).count();
+        phaseAllocations[phase] += allocations - lastSwitchAllocations;
+    }
+    lastSwitch = now;
+    lastSwitchAllocations = allocations;
+}
+
+size_t Profiler::Recent(FrameSample* out, size_t count) const {
+    size_t end = written.load(std::memory_order_acquire);
+    size_t available = end < historySize ? end : historySize;
+    if (count > available) count = available;
+
+    for (size_t i = 0; i < count; i++)
+        out[i] = ring[(end - count + i) & (historySize - 1)];
+    return count;
+}
+
+bool Profiler::WriteCsv(const char* path) const {
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+
+    fprintf(file, "frame,frame_ms");
+    for (int p = 0; p < PHASE_COUNT; p++) fprintf(file, ",%s_ms", PhaseName((ProfilePhase)p));
+    fprintf(file, ",allocations,allocated_bytes");
+    for (int p = 0; p < PHASE_COUNT; p++) fprintf(file, ",%s_allocations", PhaseName((ProfilePhase)p));
+    fprintf(file, "\n");
+
+    std::vector<FrameSample> samples(historySize);
+    size_t count = Recent(samples.data(), samples.size());
+    for (size_t i = 0; i < count; i++) {
+        const FrameSample& s = samples[i];
+        fprintf(file, "%llu,%.3f", s.frame, s.frameMs);
+        for (int p = 0; p < PHASE_COUNT; p++) fprintf(file, ",%.3f", s.phaseMs[p]);
+        fprintf(file, ",%u,%u", s.allocations, s.allocatedBytes);
+        for (int p = 0; p < PHASE_COUNT; p++) fprintf(file, ",%u", s.phaseAllocations[p]);
+        fprintf(file, "\n");
+    }
+    fclose(file);
+    return true;
+}
+
+const char* Profiler::PhaseName(ProfilePhase phase) {
+    static const char* names[] = { "input", "model", "layout", "animation", "draw" };
+    return phase < PHASE_COUNT ? names[phase] : "?";
+}
+
+Profiler& GetProfiler() {
+    static Profiler profiler;
+    return profiler;
+}
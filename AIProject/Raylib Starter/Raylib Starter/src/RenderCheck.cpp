@@ -0,0 +1,154 @@
+#include "RenderCheck.h"
+#include "FrameClock.h"
+#include "OffscreenTarget.h"
+#include "Scenario.h"
+#include "raylib.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+static void PrintUsage() {
+    printf("usage: --render <scenario> [--frames N] [--scale S] [--every K] [--save folder | --compare folder]"
+        " [--tolerance T]\n");
+    PrintScenarioNames();
+}
+
+// Counts the pixels more than `tolerance` apart in any channel and paints
+// them red in `diff` (a copy of the frame)
+static int DiffPixels(const Image& frame, const Image& golden, int tolerance, Image& diff, int& maxDelta) {
+    const unsigned char* a = (const unsigned char*)frame.data;
+    const unsigned char* b = (const unsigned char*)golden.data;
+    unsigned char* marked = (unsigned char*)diff.data;
+    size_t pixels = (size_t)frame.width * frame.height;
+    int differing = 0;
+    maxDelta = 0;
+    for (size_t i = 0; i < pixels; i++) {
+        int delta = 0;
+        for (int c = 0; c < 4; c++) delta = std::max(delta, abs(a[i * 4 + c] - b[i * 4 + c]));
+        maxDelta = std::max(maxDelta, delta);
+        if (delta <= tolerance) continue;
+        differing++;
+        marked[i * 4 + 0] = 255;
+        marked[i * 4 + 1] = marked[i * 4 + 2] = 0;
+        marked[i * 4 + 3] = 255;
+    }
+    return differing;
+}
+
+// Saves or compares one checkpoint; false when it doesn't match (or can't be written)
+static bool CheckFrame(const Image& frame, const std::string& file, bool save, int tolerance) {
+    if (save) {
+        if (ExportImage(frame, file.c_str())) return true;
+        printf("  can't write %s\n", file.c_str());
+        return false;
+    }
+
+    Image golden = LoadImage(file.c_str());
+    if (!golden.data) {
+        printf("  %s: no golden image\n", file.c_str());
+        return false;
+    }
+    if (golden.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) ImageFormat(&golden, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    bool match = false;
+    if (golden.width != frame.width || golden.height != frame.height) {
+        printf("  %s: golden is %dx%d, frame is %dx%d\n", file.c_str(), golden.width, golden.height,
+            frame.width, frame.height);
+    }
+    else {
+        Image diff = ImageCopy(frame);
+        int maxDelta;
+        int differing = DiffPixels(frame, golden, tolerance, diff, maxDelta);
+        match = differing == 0;
+        if (!match) {
+            std::string diffFile = file.substr(0, file.size() - 4) + ".diff.png";
+            ExportImage(diff, diffFile.c_str());
+            printf("  %s: %d pixels differ (by up to %d), marked in %s\n", file.c_str(), differing, maxDelta,
+                diffFile.c_str());
+        }
+        UnloadImage(diff);
+    }
+    UnloadImage(golden);
+    return match;
+}
+
+int RunRender(int argc, char** argv) {
+    if (argc < 1) {
+        PrintUsage();
+        return 1;
+    }
+    const Scenario* scenario = FindScenario(argv[0]);
+    if (!scenario) {
+        printf("unknown scenario '%s'\n", argv[0]);
+        PrintUsage();
+        return 1;
+    }
+
+    int frames = scenario->frames;
+    float scale = 1.0f;
+    int every = 60;
+    const char* folder = nullptr;
+    bool save = false;
+    int tolerance = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--frames") == 0) frames = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--scale") == 0) scale = (float)atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--every") == 0) every = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--tolerance") == 0) tolerance = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--save") == 0 || strcmp(argv[i], "--compare") == 0) {
+            folder = argv[i + 1];
+            save = strcmp(argv[i], "--save") == 0;
+        }
+    }
+    if (frames <= 0 || scale <= 0.0f || every <= 0) {
+        PrintUsage();
+        return 1;
+    }
+    if (save) {
+        std::error_code error;
+        std::filesystem::create_directories(folder, error);
+    }
+
+    OffscreenTarget target(scale, "Data Structure Visualizer (render)");
+    SetFixedFrameTime(1.0f / 60.0f);
+
+    int checked = 0, failed = 0;
+    double stepSeconds = 0.0, drawSeconds = 0.0;
+    {
+        ScenarioScene scene;
+        for (int frame = 0; frame < frames; frame++) {
+            auto start = std::chrono::steady_clock::now();
+            scenario->step(scene, frame);
+            auto drawStart = std::chrono::steady_clock::now();
+            target.Begin();
+            scenario->draw(scene);
+            target.End();
+            auto end = std::chrono::steady_clock::now();
+            stepSeconds += std::chrono::duration<double>(drawStart - start).count();
+            drawSeconds += std::chrono::duration<double>(end - drawStart).count();
+
+            // Checkpoints are read back outside the timed part
+            if (!folder || (frame % every != 0 && frame != frames - 1)) continue;
+            Image image = target.Read();
+            if (OffscreenTarget::BottomUp()) ImageFlipVertical(&image);
+            char file[64];
+            snprintf(file, sizeof(file), "/%s_%05d.png", scenario->name, frame);
+            checked++;
+            if (!CheckFrame(image, folder + std::string(file), save, tolerance)) failed++;
+            UnloadImage(image);
+        }
+    }
+    SetFixedFrameTime(0.0f);
+
+    printf("%s: %d frames at %dx%d, %s\n", scenario->name, frames, target.Width(), target.Height(),
+        OffscreenTarget::BackendName());
+    printf("  draw %.3f ms/frame (%.0f fps), update %.3f ms/frame\n", drawSeconds * 1000.0 / frames,
+        drawSeconds > 0.0 ? frames / drawSeconds : 0.0, stepSeconds * 1000.0 / frames);
+    if (folder && save) printf("  saved %d golden frames to %s\n", checked - failed, folder);
+    else if (folder) printf("  %d of %d frames match %s (tolerance %d)\n", checked - failed, checked, folder, tolerance);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+#include "Scenario.h"
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+static void StepList(ScenarioScene& scene, int frame) {
+    if (frame < 240 && frame % 40 == 0) scene.list.AddNode(10 * (frame / 40 + 1));
+    if (frame == 300) scene.list.InsertNodeAt(2, 25);
+    if (frame == 400 || frame == 460) scene.list.DeleteLastNode();
+    scene.list.UpdateAnimations();
+}
+
+static void DrawList(ScenarioScene& scene) {
+    scene.list.Draw();
+}
+
+static void StepTree(ScenarioScene& scene, int frame) {
+    static const int keys[] = { 50, 30, 70, 20, 40, 60, 80, 35, 65, 45 };
+    const int count = (int)(sizeof(keys) / sizeof(keys[0]));
+    if (frame % 60 == 0 && frame / 60 < count) scene.tree.Insert(keys[frame / 60]);
+    if (frame == 660) scene.tree.Delete(30);
+    if (frame == 780) scene.tree.Delete(50);
+    scene.tree.UpdateAnimations();
+}
+
+static void DrawTree(ScenarioScene& scene) {
+    scene.tree.Draw();
+}
+
+static void StepSort(ScenarioScene& scene, int frame) {
+    if (frame == 0) {
+        std::mt19937 rng(7);
+        std::vector<int> values(40);
+        for (int& v : values) v = (int)(rng() % 100);
+        scene.array.SetValues(values);
+    }
+    if (frame == 30) scene.array.SortWith(SORT_INSERTION);
+    scene.array.UpdateAnimations();
+}
+
+static void DrawSort(ScenarioScene& scene) {
+    scene.array.Draw();
+}
+
+static const Scenario scenarios[] = {
+    { "list", 540, StepList, DrawList },
+    { "tree", 900, StepTree, DrawTree },
+    { "sort", 600, StepSort, DrawSort },
+};
+
+const Scenario* FindScenario(const char* name) {
+    for (const Scenario& s : scenarios)
+        if (strcmp(s.name, name) == 0) return &s;
+    return nullptr;
+}
+
+void PrintScenarioNames() {
+    printf("scenarios:");
+    for (const Scenario& s : scenarios) printf(" %s", s.name);
+    printf("\n");
+}
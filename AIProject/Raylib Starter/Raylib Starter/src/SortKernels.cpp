@@ -0,0 +1,316 @@
+#include "SortKernels.h"
+#include "Cpu.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+enum KernelIsa { ISA_SCALAR, ISA_SSE41, ISA_AVX2 };
+
+static KernelIsa SelectIsa() {
+    if (GetCpuFeatures().avx2) return ISA_AVX2;
+    if (GetCpuFeatures().sse41) return ISA_SSE41;
+    return ISA_SCALAR;
+}
+
+const char* SortKernelIsa() {
+    static const char* names[] = { "scalar", "SSE4.1", "AVX2" };
+    return names[SelectIsa()];
+}
+
+// -----------------------------------------------------------------------------
+// Radix sort
+// -----------------------------------------------------------------------------
+static const int radixBits = 8;
+static const int radixBuckets = 1 << radixBits;
+static const int combineSize = 16; // keys per write-combining buffer (one cache line)
+
+static inline uint32_t RadixKey(int value) {
+    return (uint32_t)value ^ 0x80000000u; // signed order
+}
+
+static void CountDigitsScalar(const int* keys, size_t n, int shift, size_t* counts) {
+    for (size_t i = 0; i < n; i++)
+        counts[(RadixKey(keys[i]) >> shift) & (radixBuckets - 1)]++;
+}
+
+TARGET_AVX2 static void CountDigitsAvx2(const int* keys, size_t n, int shift, size_t* counts) {
+    const __m256i sign = _mm256_set1_epi32((int)0x80000000u);
+    const __m256i mask = _mm256_set1_epi32(radixBuckets - 1);
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    alignas(32) uint32_t digits[8];
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(keys + i));
+        v = _mm256_and_si256(_mm256_srl_epi32(_mm256_xor_si256(v, sign), count), mask);
+        _mm256_store_si256((__m256i*)digits, v);
+        for (int k = 0; k < 8; k++) counts[digits[k]]++;
+    }
+    CountDigitsScalar(keys + i, n - i, shift, counts);
+}
+
+TARGET_SSE41 static void CountDigitsSse(const int* keys, size_t n, int shift, size_t* counts) {
+    const __m128i sign = _mm_set1_epi32((int)0x80000000u);
+    const __m128i mask = _mm_set1_epi32(radixBuckets - 1);
+    const __m128i count = _mm_cvtsi32_si128(shift);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(keys + i));
+        v = _mm_and_si128(_mm_srl_epi32(_mm_xor_si128(v, sign), count), mask);
+        counts[_mm_extract_epi32(v, 0)]++;
+        counts[_mm_extract_epi32(v, 1)]++;
+        counts[_mm_extract_epi32(v, 2)]++;
+        counts[_mm_extract_epi32(v, 3)]++;
+    }
+    CountDigitsScalar(keys + i, n - i, shift, counts);
+}
+
+// Copies one full write-combining buffer to its destination
+TARGET_AVX2 static void FlushAvx2(int* dst, const int* buffer) {
+    _mm256_storeu_si256((__m256i*)dst, _mm256_load_si256((const __m256i*)buffer));
+    _mm256_storeu_si256((__m256i*)(dst + 8), _mm256_load_si256((const __m256i*)(buffer + 8)));
+}
+
+TARGET_SSE41 static void FlushSse(int* dst, const int* buffer) {
+    for (int k = 0; k < combineSize; k += 4)
+        _mm_storeu_si128((__m128i*)(dst + k), _mm_load_si128((const __m128i*)(buffer + k)));
+}
+
+static void FlushScalar(int* dst, const int* buffer) {
+    memcpy(dst, buffer, combineSize * sizeof(int));
+}
+
+typedef void (*CountDigitsFn)(const int*, size_t, int, size_t*);
+typedef void (*FlushFn)(int*, const int*);
+
+// Scatters src[begin, end) into dst; offsets[d] is where this slice's next key with digit d goes
+static void ScatterSlice(const int* src, size_t begin, size_t end, int* dst, int shift,
+    size_t* offsets, FlushFn flush) {
+    // Keys are staged per digit and written a cache line at a time, so the
+    // scatter touches 256 streams of full lines instead of single ints
+    alignas(64) int buffers[radixBuckets][combineSize];
+    int fill[radixBuckets] = {};
+
+    for (size_t i = begin; i < end; i++) {
+        int value = src[i];
+        uint32_t digit = (RadixKey(value) >> shift) & (radixBuckets - 1);
+        buffers[digit][fill[digit]++] = value;
+        if (fill[digit] == combineSize) {
+            flush(dst + offsets[digit], buffers[digit]);
+            offsets[digit] += combineSize;
+            fill[digit] = 0;
+        }
+    }
+    for (int d = 0; d < radixBuckets; d++) {
+        memcpy(dst + offsets[d], buffers[d], fill[d] * sizeof(int));
+        offsets[d] += fill[d];
+    }
+}
+
+void RadixSortParallel(int* data, size_t count) {
+    if (count < 2) return;
+
+    KernelIsa isa = SelectIsa();
+    CountDigitsFn countDigits = isa == ISA_AVX2 ? CountDigitsAvx2 : isa == ISA_SSE41 ? CountDigitsSse : CountDigitsScalar;
+    FlushFn flush = isa == ISA_AVX2 ? FlushAvx2 : isa == ISA_SSE41 ? FlushSse : FlushScalar;
+
+    // At least 64K keys per thread, otherwise threads cost more than they save
+    size_t threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    threads = std::max<size_t>(1, std::min(threads, count / 65536));
+
+    std::vector<int> buffer(count);
+    int* src = data;
+    int* dst = buffer.data();
+    std::vector<size_t> histograms(threads * radixBuckets);
+    std::vector<std::thread> workers;
+
+    // Runs fn(t) on every slice, on the calling thread when there is only one
+    auto forEachSlice = [&](auto fn) {
+        if (threads == 1) {
+            fn((size_t)0);
+            return;
+        }
+        workers.clear();
+        for (size_t t = 0; t < threads; t++) workers.emplace_back(fn, t);
+        for (std::thread& w : workers) w.join();
+    };
+
+    for (int shift = 0; shift < 32; shift += radixBits) {
+        std::fill(histograms.begin(), histograms.end(), 0);
+        forEachSlice([&](size_t t) {
+            size_t begin = count * t / threads, end = count * (t + 1) / threads;
+            countDigits(src + begin, end - begin, shift, &histograms[t * radixBuckets]);
+        });
+
+        // Digit-major prefix sum: all of digit 0 (thread by thread), then digit 1, ...
+        size_t sum = 0;
+        bool singleDigit = false;
+        for (int d = 0; d < radixBuckets; d++) {
+            size_t digitTotal = 0;
+            for (size_t t = 0; t < threads; t++) {
+                size_t c = histograms[t * radixBuckets + d];
+                histograms[t * radixBuckets + d] = sum;
+                sum += c;
+                digitTotal += c;
+            }
+            if (digitTotal == count) singleDigit = true;
+        }
+        if (singleDigit) continue; // this pass wouldn't move anything
+
+        forEachSlice([&](size_t t) {
+            size_t begin = count * t / threads, end = count * (t + 1) / threads;
+            ScatterSlice(src, begin, end, dst, shift, &histograms[t * radixBuckets], flush);
+        });
+        std::swap(src, dst);
+    }
+
+    if (src != data) memcpy(data, src, count * sizeof(int));
+}
+
+// -----------------------------------------------------------------------------
+// Vectorized quicksort
+// -----------------------------------------------------------------------------
+
+// For each 8-bit compare mask: lane indices of the set bits, then of the clear
+// bits. Permuting by it packs "left" keys at the front and "right" keys at the back.
+struct PartitionTables {
+    alignas(32) int32_t avx2[256][8];
+    alignas(16) uint8_t sse[16][16];
+
+    PartitionTables() {
+        for (int m = 0; m < 256; m++) {
+            int k = 0;
+            for (int lane = 0; lane < 8; lane++) if (m & (1 << lane)) avx2[m][k++] = lane;
+            for (int lane = 0; lane < 8; lane++) if (!(m & (1 << lane))) avx2[m][k++] = lane;
+        }
+        for (int m = 0; m < 16; m++) {
+            int k = 0;
+            for (int pass = 0; pass < 2; pass++) {
+                for (int lane = 0; lane < 4; lane++) {
+                    if (((m >> lane) & 1) != (pass == 0 ? 1 : 0)) continue;
+                    for (int b = 0; b < 4; b++) sse[m][k * 4 + b] = (uint8_t)(lane * 4 + b);
+                    k++;
+                }
+            }
+        }
+    }
+};
+
+static const PartitionTables partitionTables;
+
+// Partitions src[0, n) into dst: keys going left (< pivot, or <= pivot when
+// orEqual) fill dst from the front, the rest from the back. Returns the left count.
+template <bool orEqual>
+static size_t PartitionScalar(const int* src, int* dst, size_t n, int pivot) {
+    size_t left = 0, right = n;
+    for (size_t i = 0; i < n; i++) {
+        int x = src[i];
+        bool goesLeft = orEqual ? x <= pivot : x < pivot;
+        // Write both ends and keep the one that applies (no branch)
+        dst[left] = x;
+        dst[right - 1] = x;
+        left += goesLeft;
+        right -= !goesLeft;
+    }
+    return left;
+}
+
+template <bool orEqual>
+TARGET_AVX2 static size_t PartitionAvx2(const int* src, int* dst, size_t n, int pivot) {
+    const __m256i p = _mm256_set1_epi32(pivot);
+    size_t left = 0, right = n, i = 0;
+
+    // While at least 16 keys remain the two 8-wide stores can't overlap
+    for (; n - i >= 16; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+        int greater = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, p)));
+        int less = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(p, v)));
+        int mask = orEqual ? (~greater & 0xFF) : less;
+
+        __m256i order = _mm256_load_si256((const __m256i*)partitionTables.avx2[mask]);
+        __m256i packed = _mm256_permutevar8x32_epi32(v, order);
+        int leftCount = PopCount((unsigned int)mask);
+
+        _mm256_storeu_si256((__m256i*)(dst + right - 8), packed);
+        _mm256_storeu_si256((__m256i*)(dst + left), packed);
+        left += leftCount;
+        right -= 8 - leftCount;
+    }
+    return left + PartitionScalar<orEqual>(src + i, dst + left, n - i, pivot);
+}
+
+template <bool orEqual>
+TARGET_SSE41 static size_t PartitionSse(const int* src, int* dst, size_t n, int pivot) {
+    const __m128i p = _mm_set1_epi32(pivot);
+    size_t left = 0, right = n, i = 0;
+
+    for (; n - i >= 8; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        int greater = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(v, p)));
+        int less = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v, p)));
+        int mask = orEqual ? (~greater & 0xF) : less;
+
+        __m128i order = _mm_load_si128((const __m128i*)partitionTables.sse[mask]);
+        __m128i packed = _mm_shuffle_epi8(v, order);
+        int leftCount = PopCount((unsigned int)mask);
+
+        _mm_storeu_si128((__m128i*)(dst + right - 4), packed);
+        _mm_storeu_si128((__m128i*)(dst + left), packed);
+        left += leftCount;
+        right -= 4 - leftCount;
+    }
+    return left + PartitionScalar<orEqual>(src + i, dst + left, n - i, pivot);
+}
+
+struct PartitionKernels {
+    size_t (*less)(const int*, int*, size_t, int);
+    size_t (*lessOrEqual)(const int*, int*, size_t, int);
+};
+
+static int MedianOfThree(int a, int b, int c) {
+    return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+// Sorts the n keys in `cur`, leaving the result in cur when curIsOutput,
+// otherwise in `alt`. Each partition moves the keys to the other buffer.
+static void QuickSortRange(int* cur, int* alt, size_t n, int depthLimit, bool curIsOutput,
+    const PartitionKernels& kernels) {
+    if (n <= 32 || depthLimit == 0) {
+        std::sort(cur, cur + n);
+        if (!curIsOutput) memcpy(alt, cur, n * sizeof(int));
+        return;
+    }
+
+    int pivot = MedianOfThree(cur[0], cur[n / 2], cur[n - 1]);
+    size_t left = kernels.less(cur, alt, n, pivot);
+    if (left == 0) {
+        // Nothing is below the pivot: split off the keys equal to it instead.
+        // They are already in their final order.
+        left = kernels.lessOrEqual(cur, alt, n, pivot);
+        if (curIsOutput) memcpy(cur, alt, left * sizeof(int));
+        QuickSortRange(alt + left, cur + left, n - left, depthLimit - 1, !curIsOutput, kernels);
+        return;
+    }
+
+    QuickSortRange(alt, cur, left, depthLimit - 1, !curIsOutput, kernels);
+    QuickSortRange(alt + left, cur + left, n - left, depthLimit - 1, !curIsOutput, kernels);
+}
+
+void QuickSortVectorized(int* data, size_t count) {
+    if (count < 2) return;
+
+    PartitionKernels kernels;
+    KernelIsa isa = SelectIsa();
+    if (isa == ISA_AVX2) kernels = { PartitionAvx2<false>, PartitionAvx2<true> };
+    else if (isa == ISA_SSE41) kernels = { PartitionSse<false>, PartitionSse<true> };
+    else kernels = { PartitionScalar<false>, PartitionScalar<true> };
+
+    int depthLimit = 0;
+    for (size_t s = count; s > 1; s >>= 1) depthLimit += 2;
+
+    std::vector<int> scratch(count);
+    QuickSortRange(data, scratch.data(), count, depthLimit, true, kernels);
+}
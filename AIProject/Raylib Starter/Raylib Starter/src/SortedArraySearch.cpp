@@ -0,0 +1,291 @@
+#include "SortedArraySearch.h"
+#include "Cpu.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+
+// -----------------------------------------------------------------------------
+// SIMD helpers: number of keys < value among 16 consecutive keys
+// -----------------------------------------------------------------------------
+TARGET_AVX2 static int CountLess16Avx2(const int* keys, int value) {
+    __m256i x = _mm256_set1_epi32(value);
+    __m256i a = _mm256_loadu_si256((const __m256i*)keys);
+    __m256i b = _mm256_loadu_si256((const __m256i*)(keys + 8));
+    int maskA = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, a)));
+    int maskB = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, b)));
+    return PopCount((unsigned int)(maskA | (maskB << 8)));
+}
+
+TARGET_SSE41 static int CountLess16Sse(const int* keys, int value) {
+    __m128i x = _mm_set1_epi32(value);
+    __m128i lt0 = _mm_cmpgt_epi32(x, _mm_loadu_si128((const __m128i*)keys));
+    __m128i lt1 = _mm_cmpgt_epi32(x, _mm_loadu_si128((const __m128i*)(keys + 4)));
+    __m128i lt2 = _mm_cmpgt_epi32(x, _mm_loadu_si128((const __m128i*)(keys + 8)));
+    __m128i lt3 = _mm_cmpgt_epi32(x, _mm_loadu_si128((const __m128i*)(keys + 12)));
+    // Pack the four masks to bytes, one byte per key
+    __m128i packed = _mm_packs_epi16(_mm_packs_epi32(lt0, lt1), _mm_packs_epi32(lt2, lt3));
+    return PopCount((unsigned int)_mm_movemask_epi8(packed));
+}
+
+static int CountLess16Scalar(const int* keys, int value) {
+    int count = 0;
+    for (int i = 0; i < 16; i++) count += keys[i] < value;
+    return count;
+}
+
+typedef int (*CountLessFn)(const int*, int);
+
+static CountLessFn SelectCountLess() {
+    if (GetCpuFeatures().avx2) return CountLess16Avx2;
+    if (GetCpuFeatures().sse41) return CountLess16Sse;
+    return CountLess16Scalar;
+}
+
+// -----------------------------------------------------------------------------
+// Build
+// -----------------------------------------------------------------------------
+void SortedArraySearch::Build(const std::vector<int>& keys) {
+    n = (int)keys.size();
+
+    sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    sorted.resize(n + blockSize, INT_MAX);
+
+    eytzinger.assign(n + 1, INT_MAX);
+    EytzingerBuild(0, 1);
+
+    btreeBlocks = (n + blockSize - 1) / blockSize;
+    btreeStorage.assign((size_t)btreeBlocks * blockSize + blockSize, INT_MAX);
+    uintptr_t address = (uintptr_t)btreeStorage.data();
+    btree = btreeStorage.data() + ((64 - address % 64) % 64) / sizeof(int);
+    int next = 0;
+    BTreeBuild(0, next);
+}
+
+// In-order walk of the implicit tree (children of k are 2k and 2k+1)
+int SortedArraySearch::EytzingerBuild(int i, int k) {
+    if (k <= n) {
+        i = EytzingerBuild(i, 2 * k);
+        eytzinger[k] = sorted[i++];
+        i = EytzingerBuild(i, 2 * k + 1);
+    }
+    return i;
+}
+
+// Block k has blockSize + 1 children; child i is block k * (blockSize + 1) + i + 1
+void SortedArraySearch::BTreeBuild(int k, int& next) {
+    if (k >= btreeBlocks) return;
+    for (int i = 0; i < blockSize; i++) {
+        BTreeBuild(k * (blockSize + 1) + i + 1, next);
+        btree[k * blockSize + i] = next < n ? sorted[next++] : INT_MAX;
+    }
+    BTreeBuild(k * (blockSize + 1) + blockSize + 1, next);
+}
+
+// -----------------------------------------------------------------------------
+// Branchless kernels (callers have already ruled out value > largest key)
+// -----------------------------------------------------------------------------
+int SortedArraySearch::FindSorted(int value) const {
+    const int* base = sorted.data();
+    int len = n;
+    while (len > 1) {
+        int half = len / 2;
+        base += (base[half - 1] < value) * half;
+        len -= half;
+    }
+    return (int)(base - sorted.data());
+}
+
+int SortedArraySearch::FindEytzinger(int value) const {
+    const int* t = eytzinger.data();
+    unsigned int k = 1;
+    while (k <= (unsigned int)n) {
+        // Four levels ahead the 16 descendants share one cache line
+        Prefetch((const void*)((uintptr_t)t + (uintptr_t)k * 16 * sizeof(int)));
+        k = 2 * k + (t[k] < value);
+    }
+    // Undo the right turns taken after the last left turn
+    k >>= CountTrailingZeros(~k) + 1;
+    return (int)k - 1;
+}
+
+int SortedArraySearch::FindBTree(int value) const {
+    int k = 0;
+    int slot = -1;
+    while (k < btreeBlocks) {
+        int i = CountLess16Scalar(btree + k * blockSize, value);
+        slot = i < blockSize ? k * blockSize + i : slot;
+        k = k * (blockSize + 1) + i + 1;
+    }
+    return slot;
+}
+
+// -----------------------------------------------------------------------------
+// SIMD kernels
+// -----------------------------------------------------------------------------
+int SortedArraySearch::FindSortedSimd(int value) const {
+    static const CountLessFn countLess = SelectCountLess();
+
+    // Binary search down to a 16-key window, then count it in one go.
+    // Keys past the window are >= the answer and the padding is INT_MAX,
+    // so reading all 16 never over-counts.
+    const int* base = sorted.data();
+    int len = n;
+    while (len > blockSize) {
+        int half = len / 2;
+        base += (base[half - 1] < value) * half;
+        len -= half;
+    }
+    return (int)(base - sorted.data()) + countLess(base, value);
+}
+
+int SortedArraySearch::FindBTreeSimd(int value) const {
+    static const CountLessFn countLess = SelectCountLess();
+
+    int k = 0;
+    int slot = -1;
+    while (k < btreeBlocks) {
+        int i = countLess(btree + k * blockSize, value);
+        slot = i < blockSize ? k * blockSize + i : slot;
+        k = k * (blockSize + 1) + i + 1;
+    }
+    return slot;
+}
+
+// Eight queries descend together, one gather per level
+TARGET_AVX2 static void EytzingerGather8(const int* t, int n, const int* values, int* slots) {
+    __m256i x = _mm256_loadu_si256((const __m256i*)values);
+    __m256i k = _mm256_set1_epi32(1);
+
+    // Every level whose slots all exist, then one masked step for the partial last level
+    int fullLevels = 0;
+    while ((2 << fullLevels) - 1 <= n) fullLevels++;
+
+    for (int level = 0; level < fullLevels; level++) {
+        __m256i keys = _mm256_i32gather_epi32(t, k, 4);
+        __m256i less = _mm256_cmpgt_epi32(x, keys); // -1 where key < value
+        k = _mm256_sub_epi32(_mm256_add_epi32(k, k), less);
+    }
+
+    __m256i inside = _mm256_cmpgt_epi32(_mm256_set1_epi32(n + 1), k);
+    __m256i keys = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), t, k, inside, 4);
+    __m256i less = _mm256_and_si256(_mm256_cmpgt_epi32(x, keys), inside);
+    __m256i stepped = _mm256_sub_epi32(_mm256_add_epi32(k, k), less);
+    k = _mm256_blendv_epi8(k, stepped, inside);
+
+    alignas(32) unsigned int lanes[8];
+    _mm256_store_si256((__m256i*)lanes, k);
+    for (int i = 0; i < 8; i++) {
+        unsigned int slot = lanes[i] >> (CountTrailingZeros(~lanes[i]) + 1);
+        slots[i] = (int)slot - 1;
+    }
+}
+
+void SortedArraySearch::FindEytzingerSimdBatch(const int* values, int* slots, size_t count) const {
+    size_t i = 0;
+    if (GetCpuFeatures().avx2) {
+        for (; i + 8 <= count; i += 8)
+            EytzingerGather8(eytzinger.data(), n, values + i, slots + i);
+    }
+    for (; i < count; i++)
+        slots[i] = FindEytzinger(values[i]);
+}
+
+// -----------------------------------------------------------------------------
+// Public lookups
+// -----------------------------------------------------------------------------
+int SortedArraySearch::Find(int value, SearchLayout layout, SearchKernel kernel) const {
+    int slot;
+    FindBatch(&value, &slot, 1, layout, kernel);
+    return slot;
+}
+
+void SortedArraySearch::FindBatch(const int* values, int* slots, size_t count,
+    SearchLayout layout, SearchKernel kernel) const {
+    if (n == 0) {
+        std::fill(slots, slots + count, -1);
+        return;
+    }
+    int largest = sorted[n - 1];
+
+    if (layout == LAYOUT_EYTZINGER) {
+        // k collapses to 0 (slot -1) by itself when every key is smaller
+        if (kernel == KERNEL_SIMD) FindEytzingerSimdBatch(values, slots, count);
+        else for (size_t i = 0; i < count; i++) slots[i] = FindEytzinger(values[i]);
+        return;
+    }
+
+    int (SortedArraySearch::*find)(int) const;
+    if (layout == LAYOUT_SORTED) find = kernel == KERNEL_SIMD ? &SortedArraySearch::FindSortedSimd : &SortedArraySearch::FindSorted;
+    else find = kernel == KERNEL_SIMD ? &SortedArraySearch::FindBTreeSimd : &SortedArraySearch::FindBTree;
+
+    for (size_t i = 0; i < count; i++)
+        slots[i] = values[i] > largest ? -1 : (this->*find)(values[i]);
+}
+
+double SortedArraySearch::MeasureNsPerLookup(const std::vector<int>& queries,
+    SearchLayout layout, SearchKernel kernel) const {
+    std::vector<int> slots(queries.size());
+    auto start = std::chrono::steady_clock::now();
+    FindBatch(queries.data(), slots.data(), queries.size(), layout, kernel);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return queries.empty() ? 0.0 : seconds * 1e9 / queries.size();
+}
+
+void SortedArraySearch::Trace(int value, SearchLayout layout, std::vector<SearchProbe>& probes) const {
+    probes.clear();
+    if (n == 0) return;
+
+    if (layout == LAYOUT_SORTED) {
+        int base = 0;
+        int len = n;
+        while (len > 1) {
+            int half = len / 2;
+            probes.push_back({ base + half - 1, 1 });
+            base += (sorted[base + half - 1] < value) * half;
+            len -= half;
+        }
+        probes.push_back({ base, 1 });
+    }
+    else if (layout == LAYOUT_EYTZINGER) {
+        unsigned int k = 1;
+        while (k <= (unsigned int)n) {
+            probes.push_back({ (int)k - 1, 1 });
+            k = 2 * k + (eytzinger[k] < value);
+        }
+    }
+    else {
+        int k = 0;
+        while (k < btreeBlocks) {
+            probes.push_back({ k * blockSize, blockSize });
+            int i = CountLess16Scalar(btree + k * blockSize, value);
+            k = k * (blockSize + 1) + i + 1;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Layout access
+// -----------------------------------------------------------------------------
+const int* SortedArraySearch::Data(SearchLayout layout) const {
+    if (layout == LAYOUT_SORTED) return sorted.data();
+    if (layout == LAYOUT_EYTZINGER) return eytzinger.data() + 1;
+    return btree;
+}
+
+int SortedArraySearch::Cells(SearchLayout layout) const {
+    return layout == LAYOUT_BTREE ? btreeBlocks * blockSize : n;
+}
+
+const char* SortedArraySearch::LayoutName(SearchLayout layout) {
+    static const char* names[] = { "Sorted", "Eytzinger", "B-tree" };
+    return names[layout];
+}
+
+const char* SortedArraySearch::KernelName(SearchKernel kernel) {
+    if (kernel == KERNEL_BRANCHLESS) return "branchless";
+    if (GetCpuFeatures().avx2) return "AVX2";
+    if (GetCpuFeatures().sse41) return "SSE4.1";
+    return "scalar";
+}
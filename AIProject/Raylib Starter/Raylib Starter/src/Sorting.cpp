@@ -0,0 +1,356 @@
+#include "Sorting.h"
+#include <algorithm>
+#include <thread>
+
+// -----------------------------------------------------------------------------
+// Tracers. Every algorithm is a template over one of these: the null tracer
+// compiles away for full-speed runs, the recording tracer fills a SortTrace,
+// the streaming tracer passes each step on as it's made.
+// -----------------------------------------------------------------------------
+struct NullTracer {
+    static const bool parallel = true; // Fork/Join keep a parallel sort's steps apart
+
+    void Compare(size_t, size_t) {}
+    void Swap(size_t, size_t) {}
+    void Write(size_t, int) {}
+
+    NullTracer Fork(SortTrace&) { return NullTracer(); }
+    void Join(const std::vector<SortTrace>&) {}
+};
+
+struct RecordingTracer {
+    static const bool parallel = true;
+    SortTrace* out;
+
+    void Compare(size_t i, size_t j) {
+        out->events.push_back({ (uint32_t)i, (int32_t)j, SORT_OP_COMPARE });
+        out->compares++;
+    }
+    void Swap(size_t i, size_t j) {
+        out->events.push_back({ (uint32_t)i, (int32_t)j, SORT_OP_SWAP });
+        out->swaps++;
+    }
+    void Write(size_t i, int value) {
+        out->events.push_back({ (uint32_t)i, value, SORT_OP_WRITE });
+        out->writes++;
+    }
+
+    // Threads record into their own trace; Join appends them in order
+    RecordingTracer Fork(SortTrace& storage) { return RecordingTracer{ &storage }; }
+    void Join(const std::vector<SortTrace>& parts) {
+        for (const SortTrace& part : parts) {
+            out->events.insert(out->events.end(), part.events.begin(), part.events.end());
+            out->compares += part.compares;
+            out->swaps += part.swaps;
+            out->writes += part.writes;
+        }
+    }
+};
+
+// Thrown when the sink asks to stop, to unwind out of the algorithm at once
+struct SortStopped {};
+
+struct StreamingTracer {
+    static const bool parallel = false; // one sink, one thread, steps in order
+    const SortSink* sink;
+
+    void Compare(size_t i, size_t j) { Emit({ (uint32_t)i, (int32_t)j, SORT_OP_COMPARE }); }
+    void Swap(size_t i, size_t j) { Emit({ (uint32_t)i, (int32_t)j, SORT_OP_SWAP }); }
+    void Write(size_t i, int value) { Emit({ (uint32_t)i, value, SORT_OP_WRITE }); }
+    void Emit(const SortEvent& event) {
+        if (!(*sink)(event)) throw SortStopped();
+    }
+
+    StreamingTracer Fork(SortTrace&) { return *this; }
+    void Join(const std::vector<SortTrace>&) {}
+};
+
+void SortTrace::Clear() {
+    events.clear();
+    compares = swaps = writes = 0;
+}
+
+static const size_t smallRange = 16; // ranges this short finish with insertion sort
+
+// -----------------------------------------------------------------------------
+// Insertion sort on [lo, hi)
+// -----------------------------------------------------------------------------
+template <class Tracer>
+static void InsertionSortRange(int* a, size_t lo, size_t hi, Tracer& t) {
+    for (size_t i = lo + 1; i < hi; i++) {
+        int value = a[i];
+        size_t j = i;
+        while (j > lo) {
+            t.Compare(j - 1, j);
+            if (a[j - 1] <= value) break;
+            a[j] = a[j - 1];
+            t.Write(j, a[j]);
+            j--;
+        }
+        if (j != i) {
+            a[j] = value;
+            t.Write(j, value);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Merge sort (top-down, aux buffer the size of the input)
+// -----------------------------------------------------------------------------
+template <class Tracer>
+static void Merge(int* a, int* aux, size_t lo, size_t mid, size_t hi, Tracer& t) {
+    std::copy(a + lo, a + hi, aux + lo);
+    size_t i = lo, j = mid;
+    for (size_t k = lo; k < hi; k++) {
+        if (i < mid && j < hi) t.Compare(i, j);
+        if (j >= hi || (i < mid && aux[i] <= aux[j])) a[k] = aux[i++];
+        else a[k] = aux[j++];
+        t.Write(k, a[k]);
+    }
+}
+
+template <class Tracer>
+static void MergeSortRange(int* a, int* aux, size_t lo, size_t hi, Tracer& t) {
+    if (hi - lo <= smallRange) {
+        InsertionSortRange(a, lo, hi, t);
+        return;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    MergeSortRange(a, aux, lo, mid, t);
+    MergeSortRange(a, aux, mid, hi, t);
+    t.Compare(mid - 1, mid);
+    if (a[mid - 1] <= a[mid]) return; // already in order
+    Merge(a, aux, lo, mid, hi, t);
+}
+
+template <class Tracer>
+static void MergeSort(int* a, size_t n, Tracer& t) {
+    std::vector<int> aux(n);
+    MergeSortRange(a, aux.data(), 0, n, t);
+}
+
+// -----------------------------------------------------------------------------
+// Heap sort on [lo, hi)
+// -----------------------------------------------------------------------------
+template <class Tracer>
+static void SiftDown(int* a, size_t lo, size_t root, size_t size, Tracer& t) {
+    while (true) {
+        size_t child = 2 * root + 1;
+        if (child >= size) return;
+        if (child + 1 < size) {
+            t.Compare(lo + child, lo + child + 1);
+            if (a[lo + child] < a[lo + child + 1]) child++;
+        }
+        t.Compare(lo + root, lo + child);
+        if (a[lo + root] >= a[lo + child]) return;
+        std::swap(a[lo + root], a[lo + child]);
+        t.Swap(lo + root, lo + child);
+        root = child;
+    }
+}
+
+template <class Tracer>
+static void HeapSortRange(int* a, size_t lo, size_t hi, Tracer& t) {
+    size_t size = hi - lo;
+    for (size_t i = size / 2; i-- > 0;)
+        SiftDown(a, lo, i, size, t);
+    for (size_t end = size; end-- > 1;) {
+        std::swap(a[lo], a[lo + end]);
+        t.Swap(lo, lo + end);
+        SiftDown(a, lo, 0, end, t);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Introsort: quicksort with median-of-three pivots, heap sort past the depth
+// limit, insertion sort for short ranges
+// -----------------------------------------------------------------------------
+template <class Tracer>
+static void CompareSwap(int* a, size_t i, size_t j, Tracer& t) {
+    t.Compare(i, j);
+    if (a[j] < a[i]) {
+        std::swap(a[i], a[j]);
+        t.Swap(i, j);
+    }
+}
+
+// Partitions [lo, hi) (at least 3 elements) and returns the pivot's final index
+template <class Tracer>
+static size_t Partition(int* a, size_t lo, size_t hi, Tracer& t) {
+    size_t mid = lo + (hi - lo) / 2;
+    CompareSwap(a, lo, mid, t);
+    CompareSwap(a, lo, hi - 1, t);
+    CompareSwap(a, mid, hi - 1, t);
+
+    // a[lo] <= pivot <= a[hi - 1] act as sentinels for the scans below
+    std::swap(a[mid], a[hi - 2]);
+    t.Swap(mid, hi - 2);
+    int pivot = a[hi - 2];
+
+    size_t i = lo, j = hi - 2;
+    while (true) {
+        do { i++; t.Compare(i, hi - 2); } while (a[i] < pivot);
+        do { j--; t.Compare(hi - 2, j); } while (pivot < a[j]);
+        if (i >= j) break;
+        std::swap(a[i], a[j]);
+        t.Swap(i, j);
+    }
+    std::swap(a[i], a[hi - 2]);
+    t.Swap(i, hi - 2);
+    return i;
+}
+
+template <class Tracer>
+static void IntroSortRange(int* a, size_t lo, size_t hi, int depthLimit, Tracer& t) {
+    while (hi - lo > smallRange) {
+        if (depthLimit-- == 0) {
+            HeapSortRange(a, lo, hi, t);
+            return;
+        }
+        size_t p = Partition(a, lo, hi, t);
+
+        // Recurse into the smaller side so the stack stays O(log n)
+        if (p - lo < hi - p) {
+            IntroSortRange(a, lo, p, depthLimit, t);
+            lo = p + 1;
+        }
+        else {
+            IntroSortRange(a, p + 1, hi, depthLimit, t);
+            hi = p;
+        }
+    }
+    InsertionSortRange(a, lo, hi, t);
+}
+
+template <class Tracer>
+static void IntroSort(int* a, size_t n, Tracer& t) {
+    int depthLimit = 0;
+    for (size_t s = n; s > 1; s >>= 1) depthLimit += 2;
+    IntroSortRange(a, 0, n, depthLimit, t);
+}
+
+// -----------------------------------------------------------------------------
+// LSD radix sort, 8 bits per pass. Passes alternate between the input and a
+// buffer; the trace records each pass's output writes at their positions.
+// -----------------------------------------------------------------------------
+template <class Tracer>
+static void RadixSort(int* a, size_t n, Tracer& t) {
+    std::vector<int> aux(n);
+    int* src = a;
+    int* dst = aux.data();
+
+    for (int shift = 0; shift < 32; shift += 8) {
+        size_t offsets[256] = {};
+        for (size_t i = 0; i < n; i++) {
+            uint32_t key = (uint32_t)src[i] ^ 0x80000000u; // signed order
+            offsets[(key >> shift) & 0xFF]++;
+        }
+        size_t sum = 0;
+        for (size_t& offset : offsets) {
+            size_t count = offset;
+            offset = sum;
+            sum += count;
+        }
+        for (size_t i = 0; i < n; i++) {
+            uint32_t key = (uint32_t)src[i] ^ 0x80000000u;
+            size_t pos = offsets[(key >> shift) & 0xFF]++;
+            dst[pos] = src[i];
+            t.Write(pos, src[i]);
+        }
+        std::swap(src, dst);
+    }
+    // Four passes leave the result back in `a`
+}
+
+// -----------------------------------------------------------------------------
+// Parallel merge sort: chunks sorted on their own threads, then merged
+// pairwise with each round's merges also run in parallel
+// -----------------------------------------------------------------------------
+template <class Tracer>
+static void ParallelMergeSort(int* a, size_t n, Tracer& t) {
+    size_t chunks = 1;
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    while (Tracer::parallel && chunks * 2 <= threads && n / (chunks * 2) >= 4096) chunks *= 2;
+    if (chunks == 1) {
+        MergeSort(a, n, t);
+        return;
+    }
+
+    std::vector<int> aux(n);
+    std::vector<SortTrace> parts(chunks);
+    std::vector<std::thread> workers;
+
+    for (size_t c = 0; c < chunks; c++) {
+        workers.emplace_back([&, c] {
+            Tracer local = t.Fork(parts[c]);
+            MergeSortRange(a, aux.data(), n * c / chunks, n * (c + 1) / chunks, local);
+        });
+    }
+    for (std::thread& w : workers) w.join();
+    t.Join(parts);
+
+    for (size_t width = 1; width < chunks; width *= 2) {
+        size_t merges = chunks / (width * 2);
+        workers.clear();
+        std::vector<SortTrace> roundParts(merges);
+        for (size_t m = 0; m < merges; m++) {
+            workers.emplace_back([&, m] {
+                size_t first = m * width * 2;
+                size_t lo = n * first / chunks;
+                size_t mid = n * (first + width) / chunks;
+                size_t hi = n * (first + width * 2) / chunks;
+                Tracer local = t.Fork(roundParts[m]);
+                Merge(a, aux.data(), lo, mid, hi, local);
+            });
+        }
+        for (std::thread& w : workers) w.join();
+        t.Join(roundParts);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Dispatch
+// -----------------------------------------------------------------------------
+template <class Tracer>
+static void SortWith(SortAlgorithm algorithm, int* a, size_t n, Tracer& t) {
+    if (n < 2) return;
+    switch (algorithm) {
+    case SORT_INSERTION: InsertionSortRange(a, 0, n, t); break;
+    case SORT_MERGE: MergeSort(a, n, t); break;
+    case SORT_INTROSORT: IntroSort(a, n, t); break;
+    case SORT_HEAP: HeapSortRange(a, 0, n, t); break;
+    case SORT_RADIX: RadixSort(a, n, t); break;
+    case SORT_PARALLEL_MERGE: ParallelMergeSort(a, n, t); break;
+    default: break;
+    }
+}
+
+void Sort(SortAlgorithm algorithm, int* data, size_t count, SortTrace* trace) {
+    if (trace) {
+        trace->Clear();
+        RecordingTracer tracer{ trace };
+        SortWith(algorithm, data, count, tracer);
+    }
+    else {
+        NullTracer tracer;
+        SortWith(algorithm, data, count, tracer);
+    }
+}
+
+bool SortStreamed(SortAlgorithm algorithm, int* data, size_t count, const SortSink& sink) {
+    StreamingTracer tracer{ &sink };
+    try {
+        SortWith(algorithm, data, count, tracer);
+    }
+    catch (const SortStopped&) {
+        return false;
+    }
+    return true;
+}
+
+const char* SortName(SortAlgorithm algorithm) {
+    static const char* names[] = {
+        "Insertion", "Merge", "Introsort", "Heap", "LSD Radix", "Parallel Merge"
+    };
+    return algorithm < SORT_COUNT ? names[algorithm] : "?";
+}
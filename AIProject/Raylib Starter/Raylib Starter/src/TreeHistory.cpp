@@ -0,0 +1,160 @@
+#include "TreeHistory.h"
+#include <utility>
+
+TreeHistory::TreeHistory() {
+    versions.push_back({ nullptr, 0, TREE_OP_EMPTY, 0 });
+}
+
+TreeHistory::~TreeHistory() {
+    for (TreeVersion& v : versions) Release(v.root);
+}
+
+void TreeHistory::BeginEdit(TreeVersionOp op, int value) {
+    if (editing) EndEdit();
+    while (versions.size() > current + 1) {
+        Release(versions.back().root);
+        versions.pop_back();
+    }
+
+    // The new version starts as the current one
+    TreeVersion next = versions[current];
+    if (next.root) next.root->refs++;
+    next.op = op;
+    next.value = value;
+    versions.push_back(next);
+    current = versions.size() - 1;
+    editing = true;
+    editStamp++;
+}
+
+void TreeHistory::EndEdit() {
+    editing = false;
+    editStamp++; // nothing made so far may change any more
+}
+
+void TreeHistory::Select(size_t version) {
+    if (editing) EndEdit();
+    if (version < versions.size()) current = version;
+}
+
+size_t TreeHistory::SnapshotNodes() const {
+    size_t total = 0;
+    for (const TreeVersion& v : versions) total += v.nodeCount;
+    return total;
+}
+
+// -----------------------------------------------------------------------------
+// Path copying. Own replaces a shared node on the path with a private copy;
+// the copy takes a reference on both children, and the link's reference on
+// the original is dropped (the versions that share it keep theirs).
+// -----------------------------------------------------------------------------
+VersionNode* TreeHistory::Own(VersionNode*& link) {
+    VersionNode* node = link;
+    if (node->edit == editStamp) return node;
+
+    VersionNode* copy = pool.Create(*node);
+    copy->refs = 1;
+    copy->edit = editStamp;
+    if (copy->left) copy->left->refs++;
+    if (copy->right) copy->right->refs++;
+    Release(node);
+    link = copy;
+    return copy;
+}
+
+void TreeHistory::Release(VersionNode* node) {
+    if (!node || --node->refs > 0) return;
+    releaseStack.push_back(node);
+    while (!releaseStack.empty()) {
+        VersionNode* dead = releaseStack.back();
+        releaseStack.pop_back();
+        for (VersionNode* child : { dead->left, dead->right })
+            if (child && --child->refs == 0) releaseStack.push_back(child);
+        pool.Destroy(dead);
+    }
+}
+
+uint32_t TreeHistory::Insert(int value) {
+    TreeVersion& v = versions.back();
+    VersionNode** link = &v.root;
+    while (*link) {
+        VersionNode* node = Own(*link);
+        link = value < node->value ? &node->left : &node->right;
+    }
+    *link = pool.Create(VersionNode{ value, nextId, 1, editStamp, nullptr, nullptr });
+    v.nodeCount++;
+    return nextId++;
+}
+
+bool TreeHistory::Remove(int value, uint32_t* removedId) {
+    TreeVersion& v = versions.back();
+
+    // Find it first, so a miss copies nothing
+    const VersionNode* probe = v.root;
+    while (probe && probe->value != value) probe = value < probe->value ? probe->left : probe->right;
+    if (!probe) return false;
+
+    VersionNode** link = &v.root;
+    VersionNode* node = Own(*link);
+    while (node->value != value) {
+        link = value < node->value ? &node->left : &node->right;
+        node = Own(*link);
+    }
+    *removedId = node->id;
+
+    if (!node->left || !node->right) {
+        // The only child (if any) moves up, keeping the reference node held
+        *link = node->left ? node->left : node->right;
+        node->left = node->right = nullptr;
+        Release(node);
+    }
+    else {
+        // Two children: the successor's key and identity move up into node
+        VersionNode** successorLink = &node->right;
+        VersionNode* successor = Own(*successorLink);
+        while (successor->left) {
+            successorLink = &successor->left;
+            successor = Own(*successorLink);
+        }
+        node->value = successor->value;
+        node->id = successor->id;
+        *successorLink = successor->right;
+        successor->right = nullptr;
+        Release(successor);
+    }
+    v.nodeCount--;
+    return true;
+}
+
+void TreeHistory::Diff(const VersionNode* from, const VersionNode* to,
+    std::vector<const VersionNode*>& leaving, std::vector<const VersionNode*>& entering) {
+    // Explicit stack so degenerate trees can't overflow
+    std::vector<std::pair<const VersionNode*, const VersionNode*>> stack;
+    stack.push_back({ from, to });
+    while (!stack.empty()) {
+        auto [a, b] = stack.back();
+        stack.pop_back();
+        if (a == b) continue; // shared (or both empty)
+
+        // Deleting a node with one child moves that child's subtree up a
+        // level whole; pairing by position would report all of it as both
+        // leaving and entering. Match it by identity instead and skip it:
+        // only the spliced node changes (the other child is empty then).
+        if (a && b && (b == a->left || b == a->right)) {
+            leaving.push_back(a);
+            stack.push_back({ b == a->left ? a->right : a->left, nullptr });
+            continue;
+        }
+        if (a && b && (a == b->left || a == b->right)) {
+            // The same the other way round (undoing such a delete)
+            entering.push_back(b);
+            stack.push_back({ nullptr, a == b->left ? b->right : b->left });
+            continue;
+        }
+
+        if (a) leaving.push_back(a);
+        if (b) entering.push_back(b);
+        stack.push_back({ a ? a->right : nullptr, b ? b->right : nullptr });
+        stack.push_back({ a ? a->left : nullptr, b ? b->left : nullptr });
+    }
+}
@@ -0,0 +1,249 @@
+#include "TweenEngine.h"
+#include "Cpu.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static float Ease(uint8_t easing, float t) {
+    float u = 1.0f - t;
+    switch (easing) {
+    case EASE_OUT_QUAD: return 1.0f - u * u;
+    case EASE_OUT_CUBIC: return 1.0f - u * u * u;
+    default: return t;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Tick kernels. Each advances tweens [begin, end), writes every value through
+// its target and sets bit i of `settled` (zeroed by the caller) for each tween
+// that reached its end. begin is a multiple of 32, so a chunk owns whole words.
+// The SIMD kernels compute all three easings and blend by the easing id.
+// -----------------------------------------------------------------------------
+struct TweenArrays {
+    float* const* targets;
+    const float* starts;
+    const float* ends;
+    float* progress;
+    const float* rates;
+    const uint8_t* easings;
+};
+
+typedef void (*TweenKernel)(const TweenArrays& a, size_t begin, size_t end, float dt, uint32_t* settled);
+
+static void AdvanceScalar(const TweenArrays& a, size_t begin, size_t end, float dt, uint32_t* settled) {
+    for (size_t i = begin; i < end; i++) {
+        float t = std::min(1.0f, a.progress[i] + a.rates[i] * dt);
+        a.progress[i] = t;
+        if (t < 1.0f) {
+            *a.targets[i] = a.starts[i] + (a.ends[i] - a.starts[i]) * Ease(a.easings[i], t);
+        }
+        else {
+            *a.targets[i] = a.ends[i];
+            settled[i >> 5] |= 1u << (i & 31);
+        }
+    }
+}
+
+TARGET_AVX2 static void AdvanceAvx2(const TweenArrays& a, size_t begin, size_t end, float dt, uint32_t* settled) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 step = _mm256_set1_ps(dt);
+    const __m256i quadId = _mm256_set1_epi32(EASE_OUT_QUAD);
+    const __m256i cubicId = _mm256_set1_epi32(EASE_OUT_CUBIC);
+    alignas(32) float values[8];
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 t = _mm256_add_ps(_mm256_loadu_ps(a.progress + i), _mm256_mul_ps(_mm256_loadu_ps(a.rates + i), step));
+        t = _mm256_min_ps(t, one);
+        _mm256_storeu_ps(a.progress + i, t);
+
+        // eased = 1 - rest, where rest is u, u^2 or u^3 for u = 1 - t
+        __m256i easing = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(a.easings + i)));
+        __m256 u = _mm256_sub_ps(one, t);
+        __m256 uu = _mm256_mul_ps(u, u);
+        __m256 rest = _mm256_blendv_ps(u, uu, _mm256_castsi256_ps(_mm256_cmpeq_epi32(easing, quadId)));
+        rest = _mm256_blendv_ps(rest, _mm256_mul_ps(uu, u), _mm256_castsi256_ps(_mm256_cmpeq_epi32(easing, cubicId)));
+
+        __m256 start = _mm256_loadu_ps(a.starts + i);
+        __m256 stop = _mm256_loadu_ps(a.ends + i);
+        __m256 value = _mm256_add_ps(start, _mm256_mul_ps(_mm256_sub_ps(stop, start), _mm256_sub_ps(one, rest)));
+        __m256 done = _mm256_cmp_ps(t, one, _CMP_GE_OQ);
+        _mm256_store_ps(values, _mm256_blendv_ps(value, stop, done));
+
+        for (int k = 0; k < 8; k++) *a.targets[i + k] = values[k];
+        settled[i >> 5] |= (uint32_t)_mm256_movemask_ps(done) << (i & 31);
+    }
+    AdvanceScalar(a, i, end, dt, settled);
+}
+
+TARGET_SSE41 static void AdvanceSse(const TweenArrays& a, size_t begin, size_t end, float dt, uint32_t* settled) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 step = _mm_set1_ps(dt);
+    const __m128i quadId = _mm_set1_epi32(EASE_OUT_QUAD);
+    const __m128i cubicId = _mm_set1_epi32(EASE_OUT_CUBIC);
+    alignas(16) float values[4];
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 t = _mm_add_ps(_mm_loadu_ps(a.progress + i), _mm_mul_ps(_mm_loadu_ps(a.rates + i), step));
+        t = _mm_min_ps(t, one);
+        _mm_storeu_ps(a.progress + i, t);
+
+        int packed;
+        memcpy(&packed, a.easings + i, sizeof(packed));
+        __m128i easing = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+        __m128 u = _mm_sub_ps(one, t);
+        __m128 uu = _mm_mul_ps(u, u);
+        __m128 rest = _mm_blendv_ps(u, uu, _mm_castsi128_ps(_mm_cmpeq_epi32(easing, quadId)));
+        rest = _mm_blendv_ps(rest, _mm_mul_ps(uu, u), _mm_castsi128_ps(_mm_cmpeq_epi32(easing, cubicId)));
+
+        __m128 start = _mm_loadu_ps(a.starts + i);
+        __m128 stop = _mm_loadu_ps(a.ends + i);
+        __m128 value = _mm_add_ps(start, _mm_mul_ps(_mm_sub_ps(stop, start), _mm_sub_ps(one, rest)));
+        __m128 done = _mm_cmpge_ps(t, one);
+        _mm_store_ps(values, _mm_blendv_ps(value, stop, done));
+
+        for (int k = 0; k < 4; k++) *a.targets[i + k] = values[k];
+        settled[i >> 5] |= (uint32_t)_mm_movemask_ps(done) << (i & 31);
+    }
+    AdvanceScalar(a, i, end, dt, settled);
+}
+
+static TweenKernel SelectKernel() {
+    if (GetCpuFeatures().avx2) return AdvanceAvx2;
+    if (GetCpuFeatures().sse41) return AdvanceSse;
+    return AdvanceScalar;
+}
+
+const char* TweenEngine::KernelIsa() {
+    if (GetCpuFeatures().avx2) return "AVX2";
+    if (GetCpuFeatures().sse41) return "SSE4.1";
+    return "scalar";
+}
+
+void TweenEngine::Add(float* target, float to, float duration, Easing easing) {
+    if (duration <= 0.0f) {
+        Cancel(target);
+        *target = to;
+        return;
+    }
+
+    auto found = index.find(target);
+    size_t i;
+    if (found != index.end()) {
+        i = found->second; // retarget from wherever it has got to
+    }
+    else {
+        i = targets.size();
+        index.emplace(target, (uint32_t)i);
+        targets.push_back(target);
+        starts.push_back(0.0f);
+        ends.push_back(0.0f);
+        progress.push_back(0.0f);
+        rates.push_back(0.0f);
+        easings.push_back(0);
+    }
+    starts[i] = *target;
+    ends[i] = to;
+    progress[i] = 0.0f;
+    rates[i] = 1.0f / duration;
+    easings[i] = easing;
+}
+
+void TweenEngine::Tick(float dt, JobSystem& jobs) {
+    size_t count = targets.size();
+    if (count == 0) return;
+
+    static const TweenKernel simdKernel = SelectKernel();
+    TweenKernel advance = scalarKernel ? AdvanceScalar : simdKernel;
+    TweenArrays arrays = { targets.data(), starts.data(), ends.data(), progress.data(), rates.data(), easings.data() };
+
+    // Tweens are independent, so big sets are split into chunks of whole
+    // bitmask words
+    size_t words = (count + 31) / 32;
+    settled.assign(words, 0);
+    jobs.ParallelFor(words, 512, [&](size_t begin, size_t end) {
+        advance(arrays, begin * 32, std::min(end * 32, count), dt, settled.data());
+    });
+
+    // Highest index first: the tween swapped into a hole then always comes
+    // from above, where everything settled is already gone
+    for (size_t w = words; w-- > 0;) {
+        uint32_t bits = settled[w];
+        while (bits) {
+            int bit = HighestSetBit(bits);
+            RemoveAt(w * 32 + bit);
+            bits &= ~(1u << bit);
+        }
+    }
+}
+
+void TweenEngine::Cancel(float* target) {
+    auto found = index.find(target);
+    if (found != index.end()) RemoveAt(found->second);
+}
+
+void TweenEngine::CancelRange(const void* begin, size_t bytes) {
+    const char* first = (const char*)begin;
+    for (size_t i = 0; i < targets.size();) {
+        const char* p = (const char*)targets[i];
+        if (p >= first && p < first + bytes) RemoveAt(i);
+        else i++;
+    }
+}
+
+void TweenEngine::FinishAll() {
+    for (size_t i = 0; i < targets.size(); i++) *targets[i] = ends[i];
+    Clear();
+}
+
+void TweenEngine::Clear() {
+    targets.clear();
+    starts.clear();
+    ends.clear();
+    progress.clear();
+    rates.clear();
+    easings.clear();
+    index.clear();
+}
+
+void TweenEngine::Rebase(const void* oldBase, size_t bytes, void* newBase) {
+    const char* first = (const char*)oldBase;
+    for (size_t i = 0; i < targets.size(); i++) {
+        const char* p = (const char*)targets[i];
+        if (p < first || p >= first + bytes) continue;
+        index.erase(targets[i]);
+        targets[i] = (float*)((char*)newBase + (p - first));
+        index[targets[i]] = (uint32_t)i;
+    }
+}
+
+void TweenEngine::RemoveAt(size_t i) {
+    index.erase(targets[i]);
+    size_t last = targets.size() - 1;
+    if (i != last) {
+        targets[i] = targets[last];
+        starts[i] = starts[last];
+        ends[i] = ends[last];
+        progress[i] = progress[last];
+        rates[i] = rates[last];
+        easings[i] = easings[last];
+        index[targets[i]] = (uint32_t)i;
+    }
+    targets.pop_back();
+    starts.pop_back();
+    ends.pop_back();
+    progress.pop_back();
+    rates.pop_back();
+    easings.pop_back();
+}
+
+Color LerpColor(Color from, Color to, float t) {
+    t = fminf(fmaxf(t, 0.0f), 1.0f);
+    return {
+        (unsigned char)(from.r + (to.r - from.r) * t),
+        (unsigned char)(from.g + (to.g - from.g) * t),
+        (unsigned char)(from.b + (to.b - from.b) * t),
+        255
+    };
+}
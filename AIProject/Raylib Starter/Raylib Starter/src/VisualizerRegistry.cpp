@@ -0,0 +1,21 @@
+#include "VisualizerRegistry.h"
+#include "globals.h"
+
+// The list is small and cheap to rebuild, so it only sheds its extras; the
+// tree (version history, node pools) and the array (history checkpoints,
+// chart texture, sort worker) go down to their values
+VisualizerRegistry::VisualizerRegistry()
+    : list([] { return std::make_unique<LinkedListVisualizer>(); }, LEAVE_COMPACT),
+      tree([] { return std::make_unique<BinaryTreeVisualizer>(screenWidth, screenHeight); }, LEAVE_EVICT),
+      array([] { return std::make_unique<ArrayVisualizer>(screenWidth, screenHeight); }, LEAVE_EVICT) {
+}
+
+static bool Shows(AppMode mode, AppMode single) {
+    return mode == single || mode == ALL_PANES;
+}
+
+void VisualizerRegistry::Switch(AppMode from, AppMode to) {
+    if (Shows(from, LINKED_LIST) && !Shows(to, LINKED_LIST)) list.Leave();
+    if (Shows(from, BINARY_TREE) && !Shows(to, BINARY_TREE)) tree.Leave();
+    if (Shows(from, ARRAY) && !Shows(to, ARRAY)) array.Leave();
+}
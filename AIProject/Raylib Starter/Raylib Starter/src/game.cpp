@@ -1,16 +1,115 @@
 #include "raylib.h"
 #include "stdio.h"
 #include "../include/game.h"
+#include <algorithm>
 
 void Game::init()
 {
+    recentFrames.resize(300);
+    sortedFrameMs.reserve(300);
+    applyPacing();
 }
 
 void Game::draw()
 {
     DrawFPS(0, 0);
+    if (showProfiler) drawProfiler();
 }
 
 void Game::update()
 {
+    if (IsKeyPressed(KEY_F3)) showProfiler = !showProfiler;
+    if (IsKeyPressed(KEY_F4)) SetAllocationTracking(!AllocationTrackingEnabled());
+    if (IsKeyPressed(KEY_F5)) {
+        pacing = (PacingMode)((pacing + 1) % PACING_COUNT);
+        applyPacing();
+    }
+}
+
+void Game::endFrame()
+{
+    if (pacing == PACING_SLEEP) pacer.Wait();
+    else pacer.Observe();
+}
+
+void Game::applyPacing()
+{
+    // raylib's own limiter spins out the end of every frame
+    // (SUPPORT_PARTIALBUSY_WAIT_LOOP in the prebuilt raylib.lib); with it off,
+    // FramePacer sleeps the whole wait
+    pacer.SetFps(targetFps);
+    SetTargetFPS(pacing == PACING_RAYLIB ? targetFps : 0);
+}
+
+void Game::shutdown()
+{
+    // One row per frame, so runs of different builds can be compared
+    if (GetProfiler().WriteCsv("profile.csv"))
+        printf("Frame profile written to profile.csv\n");
+}
+
+void Game::drawProfiler()
+{
+    size_t count = GetProfiler().Recent(recentFrames.data(), recentFrames.size());
+    if (count == 0) return;
+
+    const int x = GetScreenWidth() - 340;
+    const int y = 10;
+    DrawRectangle(x, y, 330, 320, Fade(RAYWHITE, 0.9f));
+    DrawRectangleLines(x, y, 330, 320, DARKGRAY);
+
+    // Frame time percentiles over the last few seconds
+    sortedFrameMs.clear();
+    for (size_t i = 0; i < count; i++) sortedFrameMs.push_back(recentFrames[i].frameMs);
+    std::sort(sortedFrameMs.begin(), sortedFrameMs.end());
+    float p50 = sortedFrameMs[count / 2];
+    float p99 = sortedFrameMs[std::min(count - 1, count * 99 / 100)];
+    DrawText(TextFormat("Frame  p50 %.2f ms  p99 %.2f ms", p50, p99), x + 10, y + 8, 18, BLACK);
+
+    // Per-phase averages over the last second (allocations per frame when tracked)
+    bool tracking = AllocationTrackingEnabled();
+    size_t window = std::min<size_t>(count, 60);
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        float sum = 0.0f;
+        float allocations = 0.0f;
+        for (size_t i = count - window; i < count; i++) {
+            sum += recentFrames[i].phaseMs[p];
+            allocations += recentFrames[i].phaseAllocations[p];
+        }
+        float ms = sum / window;
+
+        int rowY = y + 34 + p * 20;
+        DrawText(TextFormat("%-9s %6.2f ms", Profiler::PhaseName((ProfilePhase)p), ms), x + 10, rowY, 16, DARKGRAY);
+        DrawRectangle(x + 170, rowY + 2, (int)std::min(90.0f, ms * 5.4f), 12, SKYBLUE); // 16.7 ms fills the bar
+        if (tracking) DrawText(TextFormat("%.0f new", allocations / window), x + 265, rowY, 16, DARKGRAY);
+    }
+
+    const FrameSample& last = recentFrames[count - 1];
+    if (tracking)
+        DrawText(TextFormat("Allocations: %u (%u bytes) last frame", last.allocations, last.allocatedBytes),
+            x + 10, y + 136, 16, last.allocations ? MAROON : DARKGREEN);
+    else
+        DrawText("F4: track allocations", x + 10, y + 136, 16, GRAY);
+
+    // Histogram of frame times, 2 ms per bucket; the last bucket holds the rest
+    const int buckets = 20;
+    int histogram[buckets] = {};
+    int tallest = 1;
+    for (size_t i = 0; i < count; i++) {
+        int b = std::min(buckets - 1, (int)(recentFrames[i].frameMs / 2.0f));
+        tallest = std::max(tallest, ++histogram[b]);
+    }
+    const int baseY = y + 260;
+    for (int b = 0; b < buckets; b++) {
+        int height = histogram[b] * 90 / tallest;
+        DrawRectangle(x + 10 + b * 15, baseY - height, 13, height, b * 2 >= 17 ? ORANGE : GREEN);
+    }
+    DrawText("0", x + 10, baseY + 2, 10, GRAY);
+    DrawText("40+ ms", x + 280, baseY + 2, 10, GRAY);
+
+    // Frame pacing: how far frames strayed from 1/60 s, and what waiting cost
+    PacingStats pacingStats = pacer.Stats();
+    DrawText(TextFormat("F5 pacing: %s", PacingName(pacing)), x + 10, baseY + 16, 16, DARKGRAY);
+    DrawText(TextFormat("Jitter p99 %.2f ms  max %.2f  CPU %.0f%%", pacingStats.p99JitterMs, pacingStats.maxJitterMs,
+        pacingStats.cpuPercent), x + 10, baseY + 36, 16, pacingStats.p99JitterMs > 1.0 ? MAROON : DARKGREEN);
 }
@@ -1,23 +1,49 @@
 ﻿#include "raylib.h"
-#include "LinkedListVisualizer.h"
-#include "BinaryTreeVisualizer.h"
-#include "ArrayVisualizer.h"
+#include "VisualizerRegistry.h"
+#include "Benchmark.h"
+#include "Exporter.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "RenderCheck.h"
+#include "game.h"
+#include <cmath>
+#include <cstring>
+
+int main(int argc, char** argv) {
+    // Benchmark mode runs headless and exits
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+        return RunBenchmarks(argc - 2, argv + 2);
+
+    // So do export and render modes, which draw offscreen
+    if (argc > 1 && strcmp(argv[1], "--export") == 0)
+        return RunExport(argc - 2, argv + 2);
+    if (argc > 1 && strcmp(argv[1], "--render") == 0)
+        return RunRender(argc - 2, argv + 2);
 
-enum AppMode { MENU, LINKED_LIST, BINARY_TREE, ARRAY };
-
-int main() {
     const int screenWidth = 1600;
     const int screenHeight = 900;
 
     InitWindow(screenWidth, screenHeight, "Data Structure Visualizer (Scaled UI)");
-    SetTargetFPS(60);
 
+    // Visualizers are made on first entry to a mode that shows them
     AppMode mode = MENU;
-    LinkedListVisualizer listVis;
-    BinaryTreeVisualizer treeVis(screenWidth, screenHeight);
-    ArrayVisualizer array(screenWidth, screenHeight);
+    AppMode shownMode = MENU;
+    VisualizerRegistry visualizers;
+
+    // Frame profiler overlay (F3), frame pacing (F5) and per-frame CSV dump on exit
+    Game game;
+    game.init();
 
     while (!WindowShouldClose()) {
+        GetProfiler().BeginFrame();
+        game.update();
+
+        // Modes picked last frame take effect here, leave policies included
+        if (mode != shownMode) {
+            visualizers.Switch(shownMode, mode);
+            shownMode = mode;
+        }
+
         BeginDrawing();
         ClearBackground(RAYWHITE);
 
@@ -29,6 +55,7 @@ int main() {
             Rectangle llBtn = { screenWidth / 2.0f - 150, 300, 300, 60 };
             Rectangle btBtn = { screenWidth / 2.0f - 150, 400, 300, 60 };
             Rectangle arrBtn = { screenWidth / 2.0f - 150, 500, 300, 60 };
+            Rectangle panesBtn = { screenWidth / 2.0f - 150, 600, 300, 60 };
 
             Vector2 mousePos = GetMousePosition();
 
@@ -43,11 +70,18 @@ int main() {
             drawMenuButton(llBtn, "Linked List");
             drawMenuButton(btBtn, "Binary Tree");
             drawMenuButton(arrBtn, "Array");
+            drawMenuButton(panesBtn, "All Panes");
+
+            // Whether each structure is in memory, kept as a snapshot, or yet to be made
+            DrawText(visualizers.list.StateName(), (int)(llBtn.x + llBtn.width + 20), (int)llBtn.y + 20, 20, GRAY);
+            DrawText(visualizers.tree.StateName(), (int)(btBtn.x + btBtn.width + 20), (int)btBtn.y + 20, 20, GRAY);
+            DrawText(visualizers.array.StateName(), (int)(arrBtn.x + arrBtn.width + 20), (int)arrBtn.y + 20, 20, GRAY);
 
             if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
                 if (CheckCollisionPointRec(mousePos, llBtn)) mode = LINKED_LIST;
                 else if (CheckCollisionPointRec(mousePos, btBtn)) mode = BINARY_TREE;
                 else if (CheckCollisionPointRec(mousePos, arrBtn)) mode = ARRAY;
+                else if (CheckCollisionPointRec(mousePos, panesBtn)) mode = ALL_PANES;
             }
         }
         else {
@@ -74,24 +108,78 @@ int main() {
 
             // --- VISUALIZER HANDLING ---
             if (mode == LINKED_LIST) {
+                LinkedListVisualizer& listVis = visualizers.list.Get();
                 listVis.Update();
                 listVis.Draw();
             }
             else if (mode == BINARY_TREE) {
+                BinaryTreeVisualizer& treeVis = visualizers.tree.Get();
                 treeVis.Update();
                 treeVis.Draw();
             }
             else if (mode == ARRAY) {
+                ArrayVisualizer& array = visualizers.array.Get();
                 array.HandleInput();
                 array.UpdateAnimations();
                 array.DrawUI();
                 array.Draw();
             }
+            else if (mode == ALL_PANES) {
+                // Every visualizer animates each frame (view only, no input);
+                // the job system spreads each one's animation set over the cores
+                LinkedListVisualizer& listVis = visualizers.list.Get();
+                BinaryTreeVisualizer& treeVis = visualizers.tree.Get();
+                ArrayVisualizer& array = visualizers.array.Get();
+                listVis.Tick();
+                treeVis.Tick();
+                array.UpdateAnimations();
+
+                // Four panes below the back button, each a scaled-down full screen
+                const float top = 70.0f;
+                float paneWidth = screenWidth / 2.0f;
+                float paneHeight = (screenHeight - top) / 2.0f;
+                float zoom = fminf(paneWidth / screenWidth, paneHeight / screenHeight);
+
+                auto beginPane = [&](int column, int row) {
+                    Camera2D camera = {};
+                    camera.offset = { column * paneWidth, top + row * paneHeight };
+                    camera.zoom = zoom;
+                    BeginScissorMode((int)camera.offset.x, (int)camera.offset.y, (int)paneWidth, (int)paneHeight);
+                    BeginMode2D(camera);
+                    };
+                auto endPane = [] {
+                    EndMode2D();
+                    EndScissorMode();
+                    };
+
+                beginPane(0, 0);
+                listVis.Draw();
+                endPane();
+
+                beginPane(1, 0);
+                treeVis.Draw();
+                endPane();
+
+                beginPane(0, 1);
+                array.DrawUI();
+                array.Draw();
+                endPane();
+
+                DrawLineEx({ paneWidth, top }, { paneWidth, (float)screenHeight }, 2, GRAY);
+                DrawLineEx({ 0, top + paneHeight }, { (float)screenWidth, top + paneHeight }, 2, GRAY);
+                DrawText(TextFormat("Job system: %d threads", (int)GetJobSystem().ThreadCount()),
+                    (int)paneWidth + 20, (int)(top + paneHeight) + 20, 20, DARKGRAY);
+                DrawText(TextFormat("%d FPS", GetFPS()), (int)paneWidth + 20, (int)(top + paneHeight) + 50, 20, DARKGRAY);
+            }
         }
 
+        game.draw();
         EndDrawing();
+        game.endFrame();
+        GetProfiler().EndFrame();
     }
 
+    game.shutdown();
     CloseWindow();
     return 0;
 }
@@ -9,7 +9,8 @@ newoption
         { "opengl33", "OpenGL 3.3"},
         { "opengl43", "OpenGL 4.3"},
         { "openges2", "OpenGL ES2"},
-        { "openges3", "OpenGL ES3"}
+        { "openges3", "OpenGL ES3"},
+        { "software", "Software renderer (rlsw), no GPU; needs --backend=sdl"}
     },
     default = "opengl33"
 }
@@ -21,11 +22,23 @@ newoption
     description = "Backend Platform to use",
     allowed = {
         { "glfw", "GLFW"},
-        { "rgfw", "RGFW"}
+        { "rgfw", "RGFW"},
+        { "sdl", "SDL2 (headless with SDL_VIDEODRIVER=offscreen)"}
     },
     default = "glfw"
 }
 
+-- Headless build of the visualizer (no display or GPU), e.g. for its --render
+-- and --export modes on a Linux server:
+--   premake5 gmake --graphics=software --backend=sdl --app="../../AIProject/Raylib Starter/Raylib Starter"
+newoption
+{
+    trigger = "app",
+    value = "PATH",
+    description = "Folder holding the app's src/ and include/ (default: the quickstart's own)",
+    default = ".."
+}
+
 function download_progress(total, current)
     local ratio = current / total;
     ratio = math.min(math.max(ratio, 0), 1);
@@ -62,6 +75,10 @@ function platform_defines()
     filter {"options:backend=rgfw"}
         defines{"PLATFORM_DESKTOP_RGFW"}
 
+    filter {"options:backend=sdl"}
+        defines{"PLATFORM_DESKTOP_SDL"}
+        buildoptions {"`pkg-config --cflags sdl2`"}
+
     filter {"options:graphics=opengl43"}
         defines{"GRAPHICS_API_OPENGL_43"}
 
@@ -80,6 +97,9 @@ function platform_defines()
     filter {"options:graphics=openges2"}
         defines{"GRAPHICS_API_OPENGL_ES2"}
 
+    filter {"options:graphics=software"}
+        defines{"GRAPHICS_API_OPENGL_11_SOFTWARE"}
+
     filter {"system:macosx"}
         disablewarnings {"deprecated-declarations"}
 
@@ -170,27 +190,34 @@ if (downloadRaylib) then
 
         filter{}
 
+        app_dir = _OPTIONS["app"] or ".."
+
         vpaths 
         {
-            ["Header Files/*"] = { "../include/**.h",  "../include/**.hpp", "../src/**.h", "../src/**.hpp"},
-            ["Source Files/*"] = {"../src/**.c", "src/**.cpp"},
-            ["Windows Resource Files/*"] = {"../src/**.rc", "src/**.ico"},
+            ["Header Files/*"] = { app_dir .. "/include/**.h",  app_dir .. "/include/**.hpp", app_dir .. "/src/**.h", app_dir .. "/src/**.hpp"},
+            ["Source Files/*"] = {app_dir .. "/src/**.c", app_dir .. "/src/**.cpp"},
+            ["Windows Resource Files/*"] = {app_dir .. "/src/**.rc", app_dir .. "/src/**.ico"},
         }
         
-        files {"../src/**.c", "../src/**.cpp", "../src/**.h", "../src/**.hpp", "../include/**.h", "../include/**.hpp"}
+        files {app_dir .. "/src/**.c", app_dir .. "/src/**.cpp", app_dir .. "/src/**.h", app_dir .. "/src/**.hpp", app_dir .. "/include/**.h", app_dir .. "/include/**.hpp"}
         
         filter {"system:windows", "action:vs*"}
-            files {"../src/*.rc", "../src/*.ico"}
+            files {app_dir .. "/src/*.rc", app_dir .. "/src/*.ico"}
 
         filter{}
         
-        includedirs { "../src" }
-        includedirs { "../include" }
+        includedirs { app_dir .. "/src" }
+        includedirs { app_dir .. "/include" }
 
         links {"raylib"}
 
         cdialect "C17"
-        cppdialect "C++17"
+        -- The visualizer (AIProject) needs C++20 for its coroutines
+        if app_dir == ".." then
+            cppdialect "C++17"
+        else
+            cppdialect "C++20"
+        end
 
         includedirs {raylib_dir .. "/src" }
         includedirs {raylib_dir .."/src/external" }
@@ -211,7 +238,13 @@ if (downloadRaylib) then
             libdirs {"../bin/%{cfg.buildcfg}"}
 
         filter "system:linux"
-            links {"pthread", "m", "dl", "rt", "X11"}
+            links {"pthread", "m", "dl", "rt"}
+
+        filter {"system:linux", "options:backend=glfw or backend=rgfw"}
+            links {"X11"}
+
+        filter {"options:backend=sdl"}
+            linkoptions {"`pkg-config --libs sdl2`"}
 
         filter "system:macosx"
             links {"OpenGL.framework", "Cocoa.framework", "IOKit.framework", "CoreFoundation.framework", "CoreAudio.framework", "CoreVideo.framework", "AudioToolbox.framework"}
@@ -245,6 +278,10 @@ if (downloadRaylib) then
 
         removefiles {raylib_dir .. "/src/rcore_*.c"}
 
+        -- SDL replaces GLFW; its sources would only need X11 for nothing
+        filter {"options:backend=sdl"}
+            removefiles {raylib_dir .. "/src/rglfw.c"}
+
         filter { "system:macosx", "files:" .. raylib_dir .. "/src/rglfw.c" }
             compileas "Objective-C"
 